@@ -0,0 +1,60 @@
+//////////////////////////////////////////////////////////////////////
+//                                                                  //
+// Part of the PCIT-CPP, under the Apache License v2.0              //
+// You may not use this file except in compliance with the License. //
+// See `http://www.apache.org/licenses/LICENSE-2.0` for info        //
+//                                                                  //
+//////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+
+#include <filesystem>
+namespace fs = std::filesystem;
+
+#include <Evo.h>
+
+namespace pcit::core{
+
+
+	// Read-only memory-mapped view of a file (mmap / MapViewOfFile).
+	// The data is backed by the OS page cache, so it isn't copied into the process and can be shared between
+	// 		processes that map the same file. Views into `getData()` are valid until the file is closed.
+	class MappedFile{
+		public:
+			MappedFile() = default;
+			~MappedFile() noexcept;
+
+			MappedFile(const MappedFile&) = delete;
+			MappedFile(MappedFile&& rhs) noexcept;
+
+			auto operator=(const MappedFile&) = delete;
+			auto operator=(MappedFile&& rhs) noexcept -> MappedFile&;
+
+
+			// returns false if failed to open or map the file
+			EVO_NODISCARD auto open(const fs::path& path) noexcept -> bool;
+			auto close() noexcept -> void;
+
+			EVO_NODISCARD auto isOpen() const noexcept -> bool { return this->is_open; };
+
+			EVO_NODISCARD auto getData() const noexcept -> std::string_view {
+				return std::string_view(this->data, this->data_size);
+			};
+
+			EVO_NODISCARD auto size() const noexcept -> size_t { return this->data_size; };
+
+		private:
+			const char* data = nullptr;
+			size_t data_size = 0;
+			bool is_open = false;
+
+			#if defined(EVO_PLATFORM_WINDOWS)
+				void* file_handle = nullptr;
+				void* mapping_handle = nullptr;
+			#endif
+	};
+
+
+};
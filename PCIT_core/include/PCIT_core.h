@@ -12,4 +12,6 @@
 #include "./version.h"
 #include "./UniqueID.h"
 #include "./Diagnostic.h"
-#include "./Printer.h"
\ No newline at end of file
+#include "./Printer.h"
+#include "./MappedFile.h"
+#include "./StringInterner.h"
\ No newline at end of file
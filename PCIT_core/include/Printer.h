@@ -53,9 +53,46 @@ namespace pcit::core{
 			auto printMagenta(std::string_view str) const noexcept -> void;
 			auto printGray(std::string_view str) const noexcept -> void;
 
+
+			// While buffering, everything printed is added to a buffer instead of being written straight away, and
+			// 		the buffer is written all at once by `flush()` (or when it gets large). Consecutive text of the
+			// 		same color shares one escape sequence, and nothing but the text itself is added if not printing
+			// 		color. Meant for printing large amounts of output (such as the tokens of a file), as printing
+			// 		each bit separately does a write (and sets and resets the color) every time.
+			// Not thread-safe (the buffer would be shared by every thread printing).
+			auto startBuffering() noexcept -> void;
+			auto stopBuffering() noexcept -> void; // flushes
+			auto flush() noexcept -> void;
+			EVO_NODISCARD auto isBuffering() const noexcept -> bool { return this->is_buffering; };
+
 			
+		private:
+			enum class Style{
+				None,
+				Fatal,
+				Error,
+				Warning,
+				Info,
+				Success,
+				Red,
+				Yellow,
+				Green,
+				Blue,
+				Cyan,
+				Magenta,
+				Gray,
+			};
+
+			auto add_to_buffer(Style style, std::string_view str) const noexcept -> void;
+			EVO_NODISCARD static auto get_style_escape_code(Style style) noexcept -> std::string_view;
+			auto flush_impl() const noexcept -> void;
+
 		private:
 			bool print_color;
+
+			bool is_buffering = false;
+			mutable std::string buffer{};
+			mutable Style buffer_style = Style::None; // style of the end of the buffer
 	};
 
 
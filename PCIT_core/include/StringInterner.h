@@ -0,0 +1,73 @@
+//////////////////////////////////////////////////////////////////////
+//                                                                  //
+// Part of the PCIT-CPP, under the Apache License v2.0              //
+// You may not use this file except in compliance with the License. //
+// See `http://www.apache.org/licenses/LICENSE-2.0` for info        //
+//                                                                  //
+//////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+
+#include <unordered_set>
+
+#include <Evo.h>
+
+namespace pcit::core{
+
+
+	// Thread-safe string interner.
+	// Strings are copied into arena blocks that are never moved or freed until the interner is destroyed, so the
+	// 		returned views are stable. Equal strings always give back the same view, so interned strings can be
+	// 		compared by their `data()` pointer.
+	// The table is split into shards (each with its own lock) picked by the hash of the string, so threads interning
+	// 		different strings rarely contend.
+	class StringInterner{
+		public:
+			StringInterner() = default;
+			~StringInterner() = default;
+
+			StringInterner(const StringInterner&) = delete;
+			StringInterner(StringInterner&&) = delete;
+
+
+			EVO_NODISCARD auto intern(std::string_view str) noexcept -> std::string_view;
+
+
+			struct MemoryUsage{
+				size_t numStrings = 0;
+				size_t arenaBytes = 0; // allocated for the characters of the strings (including unused space)
+				size_t tableBytes = 0; // estimated (the hash sets don't report what they allocate)
+			};
+
+			EVO_NODISCARD auto getMemoryUsage() const noexcept -> MemoryUsage;
+
+			// Forgets every string (invalidating all of the views to them), but keeps the arena blocks to be reused
+			// 		by the strings interned after (except for the blocks of large strings, which are freed)
+			auto clear() noexcept -> void;
+
+		private:
+			static constexpr size_t NUM_SHARDS = 16;
+			static constexpr size_t ARENA_BLOCK_SIZE = 64 * 1024;
+
+			struct alignas(64) Shard{
+				std::unordered_set<std::string_view> strings{};
+				std::vector<std::unique_ptr<char[]>> arena_blocks{}; // each is `ARENA_BLOCK_SIZE`
+				size_t num_arena_blocks_used = 0; // the rest are kept from before `clear()`
+				std::vector<std::unique_ptr<char[]>> large_blocks{}; // each has one large string
+				char* arena_cursor = nullptr;
+				size_t arena_space_left = 0;
+				size_t arena_bytes_allocated = 0;
+				size_t large_bytes_allocated = 0;
+				mutable std::mutex mutex{};
+
+				EVO_NODISCARD auto allocate(size_t size) noexcept -> char*;
+			};
+	
+		private:
+			std::array<Shard, NUM_SHARDS> shards{};
+	};
+
+
+};
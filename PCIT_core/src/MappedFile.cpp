@@ -0,0 +1,159 @@
+//////////////////////////////////////////////////////////////////////
+//                                                                  //
+// Part of the PCIT-CPP, under the Apache License v2.0              //
+// You may not use this file except in compliance with the License. //
+// See `http://www.apache.org/licenses/LICENSE-2.0` for info        //
+//                                                                  //
+//////////////////////////////////////////////////////////////////////
+
+
+#include "../include/MappedFile.h"
+
+
+#if defined(EVO_PLATFORM_WINDOWS)
+	#if !defined(WIN32_LEAN_AND_MEAN)
+		#define WIN32_LEAN_AND_MEAN
+	#endif
+
+	#if !defined(NOCOMM)
+		#define NOCOMM
+	#endif
+
+	#if !defined(NOMINMAX)
+		#define NOMINMAX
+	#endif
+	
+	#include <windows.h>
+
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+
+namespace pcit::core{
+
+
+	MappedFile::~MappedFile() noexcept {
+		this->close();
+	};
+
+
+	MappedFile::MappedFile(MappedFile&& rhs) noexcept
+		: data(std::exchange(rhs.data, nullptr)),
+		  data_size(std::exchange(rhs.data_size, 0)),
+		  is_open(std::exchange(rhs.is_open, false))
+		#if defined(EVO_PLATFORM_WINDOWS)
+			, file_handle(std::exchange(rhs.file_handle, nullptr)),
+			  mapping_handle(std::exchange(rhs.mapping_handle, nullptr))
+		#endif
+	{};
+
+
+	auto MappedFile::operator=(MappedFile&& rhs) noexcept -> MappedFile& {
+		if(this != &rhs){
+			this->close();
+			std::construct_at(this, std::move(rhs));
+		}
+
+		return *this;
+	};
+
+
+
+	auto MappedFile::open(const fs::path& path) noexcept -> bool {
+		evo::debugAssert(this->isOpen() == false, "MappedFile is already open");
+
+		#if defined(EVO_PLATFORM_WINDOWS)
+			const HANDLE win_file_handle = ::CreateFileW(
+				path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr
+			);
+			if(win_file_handle == INVALID_HANDLE_VALUE){ return false; }
+
+			LARGE_INTEGER win_file_size;
+			if(::GetFileSizeEx(win_file_handle, &win_file_size) == 0){
+				::CloseHandle(win_file_handle);
+				return false;
+			}
+
+			this->file_handle = win_file_handle;
+			this->data_size = size_t(win_file_size.QuadPart);
+			this->is_open = true;
+
+			// mapping an empty file is an error, so there's nothing to map
+			if(this->data_size == 0){ return true; }
+
+			this->mapping_handle = ::CreateFileMappingW(win_file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if(this->mapping_handle == nullptr){
+				this->close();
+				return false;
+			}
+
+			this->data = static_cast<const char*>(::MapViewOfFile(this->mapping_handle, FILE_MAP_READ, 0, 0, 0));
+			if(this->data == nullptr){
+				this->close();
+				return false;
+			}
+
+			return true;
+
+		#else
+			const int file_descriptor = ::open(path.c_str(), O_RDONLY);
+			if(file_descriptor == -1){ return false; }
+
+			struct stat file_stat;
+			if(::fstat(file_descriptor, &file_stat) == -1){
+				::close(file_descriptor);
+				return false;
+			}
+
+			this->data_size = size_t(file_stat.st_size);
+			this->is_open = true;
+
+			// mapping an empty file is an error, so there's nothing to map
+			if(this->data_size == 0){
+				::close(file_descriptor);
+				return true;
+			}
+
+			void* mapped_data = ::mmap(nullptr, this->data_size, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+
+			// the mapping stays valid after the file descriptor is closed
+			::close(file_descriptor);
+
+			if(mapped_data == MAP_FAILED){
+				this->data_size = 0;
+				this->is_open = false;
+				return false;
+			}
+
+			this->data = static_cast<const char*>(mapped_data);
+			return true;
+		#endif
+	};
+
+
+	auto MappedFile::close() noexcept -> void {
+		if(this->isOpen() == false){ return; }
+
+		#if defined(EVO_PLATFORM_WINDOWS)
+			if(this->data != nullptr){ ::UnmapViewOfFile(this->data); }
+			if(this->mapping_handle != nullptr){ ::CloseHandle(this->mapping_handle); }
+			if(this->file_handle != nullptr){ ::CloseHandle(this->file_handle); }
+
+			this->mapping_handle = nullptr;
+			this->file_handle = nullptr;
+
+		#else
+			if(this->data != nullptr){ ::munmap(const_cast<char*>(this->data), this->data_size); }
+		#endif
+
+		this->data = nullptr;
+		this->data_size = 0;
+		this->is_open = false;
+	};
+
+	
+};
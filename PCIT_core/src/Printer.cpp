@@ -68,6 +68,8 @@ namespace pcit::core{
 
 
 	Printer::~Printer() noexcept {
+		this->flush_impl();
+
 		#if defined(EVO_PLATFORM_WINDOWS)
 			if(
 				this->isPrintingColor() && 
@@ -90,7 +92,13 @@ namespace pcit::core{
 		#endif
 	};
 
-	Printer::Printer(Printer&& rhs) noexcept : print_color(rhs.print_color) {
+	Printer::Printer(Printer&& rhs) noexcept
+		: print_color(rhs.print_color),
+		  is_buffering(rhs.is_buffering),
+		  buffer(std::move(rhs.buffer)),
+		  buffer_style(rhs.buffer_style) {
+		rhs.is_buffering = false;
+
 		#if defined(EVO_PLATFORM_WINDOWS)
 			rhs.print_color = false;
 		#endif
@@ -118,11 +126,15 @@ namespace pcit::core{
 
 
 	auto Printer::print(std::string_view str) const noexcept -> void {
+		if(this->isBuffering()){ this->add_to_buffer(Style::None, str); return; }
+
 		evo::print(str);
 	};
 	
 
 	auto Printer::printFatal(std::string_view str) const noexcept -> void {
+		if(this->isBuffering()){ this->add_to_buffer(Style::Fatal, str); return; }
+
 		if(this->isPrintingColor()){
 			evo::styleConsole::fatal();
 			evo::print(str);
@@ -133,6 +145,8 @@ namespace pcit::core{
 	};
 	
 	auto Printer::printError(std::string_view str) const noexcept -> void {
+		if(this->isBuffering()){ this->add_to_buffer(Style::Error, str); return; }
+
 		if(this->isPrintingColor()){
 			evo::styleConsole::error();
 			evo::print(str);
@@ -143,6 +157,8 @@ namespace pcit::core{
 	};
 	
 	auto Printer::printWarning(std::string_view str) const noexcept -> void {
+		if(this->isBuffering()){ this->add_to_buffer(Style::Warning, str); return; }
+
 		if(this->isPrintingColor()){
 			evo::styleConsole::warning();
 			evo::print(str);
@@ -153,6 +169,8 @@ namespace pcit::core{
 	};
 	
 	auto Printer::printInfo(std::string_view str) const noexcept -> void {
+		if(this->isBuffering()){ this->add_to_buffer(Style::Info, str); return; }
+
 		if(this->isPrintingColor()){
 			evo::styleConsole::info();
 			evo::print(str);
@@ -163,6 +181,8 @@ namespace pcit::core{
 	};
 
 	auto Printer::printSuccess(std::string_view str) const noexcept -> void {
+		if(this->isBuffering()){ this->add_to_buffer(Style::Success, str); return; }
+
 		if(this->isPrintingColor()){
 			evo::styleConsole::success();
 			evo::print(str);
@@ -174,6 +194,8 @@ namespace pcit::core{
 	
 
 	auto Printer::printRed(std::string_view str) const noexcept -> void {
+		if(this->isBuffering()){ this->add_to_buffer(Style::Red, str); return; }
+
 		if(this->isPrintingColor()){
 			evo::styleConsole::text::red();
 			evo::print(str);
@@ -184,6 +206,8 @@ namespace pcit::core{
 	};
 	
 	auto Printer::printYellow(std::string_view str) const noexcept -> void {
+		if(this->isBuffering()){ this->add_to_buffer(Style::Yellow, str); return; }
+
 		if(this->isPrintingColor()){
 			evo::styleConsole::text::yellow();
 			evo::print(str);
@@ -194,6 +218,8 @@ namespace pcit::core{
 	};
 	
 	auto Printer::printGreen(std::string_view str) const noexcept -> void {
+		if(this->isBuffering()){ this->add_to_buffer(Style::Green, str); return; }
+
 		if(this->isPrintingColor()){
 			evo::styleConsole::text::green();
 			evo::print(str);
@@ -204,6 +230,8 @@ namespace pcit::core{
 	};
 	
 	auto Printer::printBlue(std::string_view str) const noexcept -> void {
+		if(this->isBuffering()){ this->add_to_buffer(Style::Blue, str); return; }
+
 		if(this->isPrintingColor()){
 			evo::styleConsole::text::blue();
 			evo::print(str);
@@ -214,6 +242,8 @@ namespace pcit::core{
 	};
 	
 	auto Printer::printCyan(std::string_view str) const noexcept -> void {
+		if(this->isBuffering()){ this->add_to_buffer(Style::Cyan, str); return; }
+
 		if(this->isPrintingColor()){
 			evo::styleConsole::text::cyan();
 			evo::print(str);
@@ -224,6 +254,8 @@ namespace pcit::core{
 	};
 	
 	auto Printer::printMagenta(std::string_view str) const noexcept -> void {
+		if(this->isBuffering()){ this->add_to_buffer(Style::Magenta, str); return; }
+
 		if(this->isPrintingColor()){
 			evo::styleConsole::text::magenta();
 			evo::print(str);
@@ -234,6 +266,8 @@ namespace pcit::core{
 	};
 	
 	auto Printer::printGray(std::string_view str) const noexcept -> void {
+		if(this->isBuffering()){ this->add_to_buffer(Style::Gray, str); return; }
+
 		if(this->isPrintingColor()){
 			evo::styleConsole::text::gray();
 			evo::print(str);
@@ -242,11 +276,76 @@ namespace pcit::core{
 			evo::print(str);
 		}
 	};
-	
 
 
 
+	//////////////////////////////////////////////////////////////////////
+	// buffering
+
+	// ANSI escape codes (also used on Windows, as consoles there are set to process them when printing color)
+	// 	Each one starts with a reset (`0;`) so it replaces all of the last style (like the background of Fatal)
+	auto Printer::get_style_escape_code(Style style) noexcept -> std::string_view {
+		switch(style){
+			break; case Style::None:    return "\x1b[0m";
+			break; case Style::Fatal:   return "\x1b[0;97;41m";
+			break; case Style::Error:   return "\x1b[0;91m";
+			break; case Style::Warning: return "\x1b[0;93m";
+			break; case Style::Info:    return "\x1b[0;96m";
+			break; case Style::Success: return "\x1b[0;92m";
+			break; case Style::Red:     return "\x1b[0;31m";
+			break; case Style::Yellow:  return "\x1b[0;33m";
+			break; case Style::Green:   return "\x1b[0;32m";
+			break; case Style::Blue:    return "\x1b[0;34m";
+			break; case Style::Cyan:    return "\x1b[0;36m";
+			break; case Style::Magenta: return "\x1b[0;35m";
+			break; case Style::Gray:    return "\x1b[0;90m";
+		};
+
+		evo::debugFatalBreak("Unknown or unsupported style");
+	};
+
+	// written once the buffer gets this big (so buffering a huge amount of output doesn't hold all of it)
+	static constexpr size_t MAX_BUFFER_SIZE = 1 << 20;
+
+
+	auto Printer::startBuffering() noexcept -> void {
+		this->is_buffering = true;
+	};
+
+	auto Printer::stopBuffering() noexcept -> void {
+		this->flush_impl();
+		this->is_buffering = false;
+	};
+
+	auto Printer::flush() noexcept -> void {
+		this->flush_impl();
+	};
+
+
+	auto Printer::add_to_buffer(Style style, std::string_view str) const noexcept -> void {
+		if(this->isPrintingColor() && style != this->buffer_style){
+			// every style code starts with a reset, so nothing of the last style stays on
+			this->buffer += get_style_escape_code(style);
+			this->buffer_style = style;
+		}
+
+		this->buffer += str;
+
+		if(this->buffer.size() >= MAX_BUFFER_SIZE){ this->flush_impl(); }
+	};
+
+
+	auto Printer::flush_impl() const noexcept -> void {
+		if(this->buffer.empty()){ return; }
+
+		if(this->buffer_style != Style::None){
+			this->buffer += get_style_escape_code(Style::None);
+			this->buffer_style = Style::None;
+		}
+
+		evo::print(this->buffer);
+		this->buffer.clear();
+	};
 
 
-	
 };
\ No newline at end of file
@@ -0,0 +1,95 @@
+//////////////////////////////////////////////////////////////////////
+//                                                                  //
+// Part of the PCIT-CPP, under the Apache License v2.0              //
+// You may not use this file except in compliance with the License. //
+// See `http://www.apache.org/licenses/LICENSE-2.0` for info        //
+//                                                                  //
+//////////////////////////////////////////////////////////////////////
+
+
+#include "../include/StringInterner.h"
+
+namespace pcit::core{
+	
+
+	auto StringInterner::intern(std::string_view str) noexcept -> std::string_view {
+		if(str.empty()){ return std::string_view(); }
+
+		const size_t hash = std::hash<std::string_view>{}(str);
+		Shard& shard = this->shards[hash % NUM_SHARDS];
+
+		const auto lock_guard = std::lock_guard(shard.mutex);
+
+		const auto find = shard.strings.find(str);
+		if(find != shard.strings.end()){ return *find; }
+
+		char* saved_str = shard.allocate(str.size());
+		std::memcpy(saved_str, str.data(), str.size());
+
+		const auto saved_str_view = std::string_view(saved_str, str.size());
+		shard.strings.emplace(saved_str_view);
+		return saved_str_view;
+	};
+
+
+	auto StringInterner::getMemoryUsage() const noexcept -> MemoryUsage {
+		auto memory_usage = MemoryUsage();
+
+		for(const Shard& shard : this->shards){
+			const auto lock_guard = std::lock_guard(shard.mutex);
+
+			memory_usage.numStrings += shard.strings.size();
+			memory_usage.arenaBytes += shard.arena_bytes_allocated + shard.large_bytes_allocated;
+
+			// a bucket pointer for each bucket, and a node (next pointer, cached hash, and the view) for each string
+			memory_usage.tableBytes += shard.strings.bucket_count() * sizeof(void*)
+				+ shard.strings.size() * (sizeof(void*) + sizeof(size_t) + sizeof(std::string_view))
+				+ (shard.arena_blocks.capacity() + shard.large_blocks.capacity()) * sizeof(std::unique_ptr<char[]>);
+		}
+
+		return memory_usage;
+	};
+
+
+	auto StringInterner::clear() noexcept -> void {
+		for(Shard& shard : this->shards){
+			const auto lock_guard = std::lock_guard(shard.mutex);
+
+			shard.strings.clear(); // keeps the buckets
+
+			shard.large_blocks.clear();
+			shard.large_bytes_allocated = 0;
+
+			shard.num_arena_blocks_used = 0;
+			shard.arena_cursor = nullptr;
+			shard.arena_space_left = 0;
+		}
+	};
+
+
+	auto StringInterner::Shard::allocate(size_t size) noexcept -> char* {
+		// large strings get their own block so they don't waste the rest of the current one
+		if(size > ARENA_BLOCK_SIZE / 4){
+			this->large_bytes_allocated += size;
+			return this->large_blocks.emplace_back(std::make_unique<char[]>(size)).get();
+		}
+
+		if(size > this->arena_space_left){
+			if(this->num_arena_blocks_used == this->arena_blocks.size()){
+				this->arena_blocks.emplace_back(std::make_unique<char[]>(ARENA_BLOCK_SIZE));
+				this->arena_bytes_allocated += ARENA_BLOCK_SIZE;
+			}
+
+			this->arena_cursor = this->arena_blocks[this->num_arena_blocks_used].get();
+			this->arena_space_left = ARENA_BLOCK_SIZE;
+			this->num_arena_blocks_used += 1;
+		}
+
+		char* allocated = this->arena_cursor;
+		this->arena_cursor += size;
+		this->arena_space_left -= size;
+		return allocated;
+	};
+
+
+};
@@ -0,0 +1,271 @@
+//////////////////////////////////////////////////////////////////////
+//                                                                  //
+// Part of the PCIT-CPP, under the Apache License v2.0              //
+// You may not use this file except in compliance with the License. //
+// See `http://www.apache.org/licenses/LICENSE-2.0` for info        //
+//                                                                  //
+//////////////////////////////////////////////////////////////////////
+
+
+#include "./corpora.h"
+
+#include <array>
+#include <fstream>
+
+namespace pthr::bench{
+
+
+	static constexpr auto WORDS = std::to_array<std::string_view>({
+		"value", "index", "count", "buffer", "source", "token", "result", "offset", "length", "context", "worker",
+		"data", "node", "parent", "child", "entry", "table", "kind", "location", "scope", "symbol", "lhs", "rhs",
+	});
+
+	static constexpr auto TYPE_NAMES = std::to_array<std::string_view>({
+		"Int", "UInt", "Bool", "Char", "String", "F64", "Source", "Token", "Buffer", "Node",
+	});
+
+
+	// Generates the lines of code that make up a corpus.
+	// Uses its own xorshift generator (instead of a standard distribution) as the standard distributions give
+	// 		different results on different standard libraries.
+	class CodeGenerator{
+		public:
+			CodeGenerator(CorpusKind _kind, uint64_t seed) noexcept : kind(_kind), rng_state(seed | 1) {};
+			~CodeGenerator() = default;
+
+			auto appendLine(std::string& code) noexcept -> void {
+				switch(this->kind){
+					break; case CorpusKind::Identifiers:    this->append_identifiers_line(code);
+					break; case CorpusKind::Comments:       this->append_comment_line(code);
+					break; case CorpusKind::NumberLiterals: this->append_number_literals_line(code);
+					break; case CorpusKind::StringLiterals: this->append_string_literals_line(code);
+					break; case CorpusKind::Mixed: {
+						switch(this->random(8)){
+							break; case 0: this->append_comment_line(code);
+							break; case 1: this->append_number_literals_line(code);
+							break; case 2: this->append_string_literals_line(code);
+							break; default: this->append_identifiers_line(code);
+						};
+					}
+				};
+			};
+
+		private:
+			// code that is mostly identifiers (and the punctuation between them)
+			auto append_identifiers_line(std::string& code) noexcept -> void {
+				switch(this->random(6)){
+					break; case 0: {
+						code += "func ";
+						this->append_identifier(code);
+						code += " = (";
+						this->append_identifier(code);
+						code += ": ";
+						this->append_type(code);
+						code += ", ";
+						this->append_identifier(code);
+						code += ": ";
+						this->append_type(code);
+						code += ") -> ";
+						this->append_type(code);
+						code += " {}\n";
+					}
+
+					break; case 1: {
+						code += "\t[";
+						this->append_identifier(code);
+						code += ", ";
+						this->append_identifier(code);
+						code += "] -> ";
+						this->append_identifier(code);
+						code += " | ";
+						this->append_identifier(code);
+						code += ";\n";
+					}
+
+					break; case 2: {
+						code += "\t@";
+						this->append_identifier(code);
+						code += "(";
+						this->append_identifier(code);
+						code += "); #";
+						this->append_identifier(code);
+						code += "\n";
+					}
+
+					break; default: {
+						code += "\tvar ";
+						this->append_identifier(code);
+						code += ": ";
+						this->append_type(code);
+						code += " = ";
+						this->append_identifier(code);
+						code += ";\n";
+					}
+				};
+			};
+
+			auto append_comment_line(std::string& code) noexcept -> void {
+				switch(this->random(8)){
+					break; case 0: {
+						code += "/* ";
+						this->append_words(code, 4 + this->random(12));
+						code += "\n\t";
+						this->append_words(code, 4 + this->random(12));
+						code += " /* nested */ */\n";
+					}
+
+					break; case 1: {
+						// comments are rarely the only thing in a file
+						this->append_identifiers_line(code);
+					}
+
+					break; default: {
+						code += "// ";
+						this->append_words(code, 4 + this->random(12));
+						code += '\n';
+					}
+				};
+			};
+
+			auto append_number_literals_line(std::string& code) noexcept -> void {
+				code += "\tvar ";
+				this->append_identifier(code);
+				code += " = ";
+
+				const size_t num_literals = 1 + this->random(8);
+				for(size_t i = 0; i < num_literals; i+=1){
+					if(i != 0){ code += ", "; }
+					this->append_number_literal(code);
+				}
+
+				code += ";\n";
+			};
+
+			auto append_string_literals_line(std::string& code) noexcept -> void {
+				code += "\tvar ";
+				this->append_identifier(code);
+
+				if(this->random(4) == 0){
+					code += ": Char = '";
+					switch(this->random(4)){
+						break; case 0: code += "\\n";
+						break; case 1: code += "\\'";
+						break; default: code += char('a' + this->random(26));
+					};
+					code += "';\n";
+					return;
+				}
+
+				code += ": String = \"";
+				const size_t num_words = 1 + this->random(10);
+				for(size_t i = 0; i < num_words; i+=1){
+					if(i != 0){
+						switch(this->random(16)){
+							break; case 0: code += "\\t";
+							break; case 1: code += "\\n";
+							break; case 2: code += "\\\"";
+							break; default: code += ' ';
+						};
+					}
+					code += WORDS[this->random(WORDS.size())];
+				}
+				code += "\";\n";
+			};
+
+
+			auto append_identifier(std::string& code) noexcept -> void {
+				code += WORDS[this->random(WORDS.size())];
+
+				if(this->random(2) == 0){
+					code += '_';
+					code += WORDS[this->random(WORDS.size())];
+				}
+
+				if(this->random(4) == 0){
+					code += std::to_string(this->random(100));
+				}
+			};
+
+			auto append_type(std::string& code) noexcept -> void {
+				code += TYPE_NAMES[this->random(TYPE_NAMES.size())];
+			};
+
+			auto append_words(std::string& code, size_t num_words) noexcept -> void {
+				for(size_t i = 0; i < num_words; i+=1){
+					if(i != 0){ code += ' '; }
+					code += WORDS[this->random(WORDS.size())];
+				}
+			};
+
+			auto append_number_literal(std::string& code) noexcept -> void {
+				switch(this->random(8)){
+					break; case 0: code += std::format("0x{:X}", this->random(1 << 24));
+					break; case 1: code += std::format("0b{:b}", this->random(1 << 12));
+					break; case 2: code += std::format("0o{:o}", this->random(1 << 18));
+					break; case 3: code += std::format("{}_{:03}", 1 + this->random(999), this->random(1000));
+					break; case 4: code += std::format("{}.{}", this->random(1000), this->random(1000));
+					break; case 5: {
+						code += std::format("{}.{}e-{}", 1 + this->random(9), this->random(100), this->random(20));
+					}
+					break; case 6: code += std::format("{}e{}", 1 + this->random(9), this->random(19)); // fits a UI64
+					break; default: code += std::to_string(this->random(1'000'000'000));
+				};
+			};
+
+
+			// in the range [0, max)
+			EVO_NODISCARD auto random(size_t max) noexcept -> size_t {
+				this->rng_state ^= this->rng_state << 13;
+				this->rng_state ^= this->rng_state >> 7;
+				this->rng_state ^= this->rng_state << 17;
+				return size_t(this->rng_state % max);
+			};
+	
+		private:
+			CorpusKind kind;
+			uint64_t rng_state;
+	};
+
+
+
+	auto generateCorpus(
+		const fs::path& directory, std::string_view name, CorpusKind kind, size_t num_bytes, size_t num_files
+	) noexcept -> std::optional<Corpus> {
+		evo::debugAssert(num_files > 0, "Corpus needs at least 1 file");
+
+		auto error_code = std::error_code();
+		fs::create_directories(directory, error_code);
+		if(error_code){ return std::nullopt; }
+
+		auto corpus = Corpus(std::string(name), std::vector<fs::path>(), 0);
+		corpus.files.reserve(num_files);
+
+		const size_t bytes_per_file = num_bytes / num_files;
+
+		auto code = std::string();
+		code.reserve(bytes_per_file + 256);
+
+		for(size_t i = 0; i < num_files; i+=1){
+			auto code_generator = CodeGenerator(kind, uint64_t(i + 1) * 0x9E37'79B9'7F4A'7C15);
+
+			code.clear();
+			while(code.size() < bytes_per_file){
+				code_generator.appendLine(code);
+			};
+
+			const fs::path file_path = directory / std::format("{}_{}.pthr", name, i);
+
+			auto file = std::ofstream(file_path, std::ios::binary | std::ios::trunc);
+			file.write(code.data(), std::streamsize(code.size()));
+			file.close();
+			if(file.fail()){ return std::nullopt; }
+
+			corpus.files.emplace_back(file_path);
+			corpus.numBytes += code.size();
+		}
+
+		return corpus;
+	};
+
+
+};
@@ -0,0 +1,46 @@
+//////////////////////////////////////////////////////////////////////
+//                                                                  //
+// Part of the PCIT-CPP, under the Apache License v2.0              //
+// You may not use this file except in compliance with the License. //
+// See `http://www.apache.org/licenses/LICENSE-2.0` for info        //
+//                                                                  //
+//////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+
+#include <filesystem>
+namespace fs = std::filesystem;
+
+#include <Evo.h>
+
+
+namespace pthr::bench{
+
+	
+	// what the code of a corpus is made up of (mostly)
+	enum class CorpusKind{
+		Identifiers,
+		Comments,
+		NumberLiterals,
+		StringLiterals,
+		Mixed,
+	};
+
+	struct Corpus{
+		std::string name;
+		std::vector<fs::path> files;
+		size_t numBytes;
+	};
+
+
+	// Writes about `num_bytes` of valid code (split evenly between `num_files` files) to new files in `directory`.
+	// The same arguments always generate the exact same files (on every platform) so results can be compared over time.
+	// Returns nullopt if any file couldn't be written.
+	EVO_NODISCARD auto generateCorpus(
+		const fs::path& directory, std::string_view name, CorpusKind kind, size_t num_bytes, size_t num_files
+	) noexcept -> std::optional<Corpus>;
+
+
+};
@@ -0,0 +1,391 @@
+//////////////////////////////////////////////////////////////////////
+//                                                                  //
+// Part of the PCIT-CPP, under the Apache License v2.0              //
+// You may not use this file except in compliance with the License. //
+// See `http://www.apache.org/licenses/LICENSE-2.0` for info        //
+//                                                                  //
+//////////////////////////////////////////////////////////////////////
+
+
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include <ranges>
+
+#include <Evo.h>
+
+#include <Panther.h>
+namespace panther = pcit::panther;
+
+#include "./corpora.h"
+namespace bench = pthr::bench;
+
+
+//////////////////////////////////////////////////////////////////////
+// allocation counting
+// 	(every allocation in the process goes through these, so the count includes the standard library's allocations)
+
+static std::atomic<size_t> num_allocations = 0;
+
+auto operator new(size_t size) -> void* {
+	num_allocations.fetch_add(1, std::memory_order_relaxed);
+	if(void* ptr = std::malloc(size == 0 ? 1 : size); ptr != nullptr){ return ptr; }
+	std::abort();
+};
+
+auto operator new[](size_t size) -> void* {
+	return ::operator new(size);
+};
+
+auto operator new(size_t size, const std::nothrow_t&) noexcept -> void* {
+	num_allocations.fetch_add(1, std::memory_order_relaxed);
+	return std::malloc(size == 0 ? 1 : size);
+};
+
+auto operator new[](size_t size, const std::nothrow_t& nothrow) noexcept -> void* {
+	return ::operator new(size, nothrow);
+};
+
+auto operator delete(void* ptr) noexcept -> void { std::free(ptr); };
+auto operator delete[](void* ptr) noexcept -> void { std::free(ptr); };
+auto operator delete(void* ptr, size_t) noexcept -> void { std::free(ptr); };
+auto operator delete[](void* ptr, size_t) noexcept -> void { std::free(ptr); };
+auto operator delete(void* ptr, const std::nothrow_t&) noexcept -> void { std::free(ptr); };
+auto operator delete[](void* ptr, const std::nothrow_t&) noexcept -> void { std::free(ptr); };
+
+
+
+//////////////////////////////////////////////////////////////////////
+// config
+
+struct Config{
+	size_t corpus_size; // bytes per corpus
+	size_t num_repetitions; // the fastest of each is reported
+	std::vector<evo::uint> thread_counts; // 0 is single-threaded
+	bool memory_map_files;
+	bool json; // one JSON object per line instead of a table
+};
+
+
+EVO_NODISCARD static auto parse_thread_counts(std::string_view str) noexcept -> std::optional<std::vector<evo::uint>> {
+	auto thread_counts = std::vector<evo::uint>();
+
+	while(str.empty() == false){
+		const size_t comma_index = std::min(str.find(','), str.size());
+
+		evo::uint thread_count;
+		const std::from_chars_result result = std::from_chars(str.data(), str.data() + comma_index, thread_count);
+		if(result.ec != std::errc() || result.ptr != str.data() + comma_index){ return std::nullopt; }
+
+		thread_counts.emplace_back(thread_count);
+		str.remove_prefix(std::min(comma_index + 1, str.size()));
+	};
+
+	if(thread_counts.empty()){ return std::nullopt; }
+	return thread_counts;
+};
+
+
+EVO_NODISCARD static auto parse_number(std::string_view str) noexcept -> std::optional<size_t> {
+	size_t number;
+	const std::from_chars_result result = std::from_chars(str.data(), str.data() + str.size(), number);
+	if(result.ec != std::errc() || result.ptr != str.data() + str.size() || number == 0){ return std::nullopt; }
+	return number;
+};
+
+
+
+//////////////////////////////////////////////////////////////////////
+// running
+
+struct RunResult{
+	std::chrono::duration<double> loadTime;
+	std::chrono::duration<double> tokenizeTime;
+	size_t numTokens;
+	size_t numTokenizeAllocations;
+};
+
+
+// returns nullopt if loading / tokenizing errored
+EVO_NODISCARD static auto run(const Config& config, const bench::Corpus& corpus, evo::uint num_threads) noexcept
+-> std::optional<RunResult> {
+	auto printer = pcit::core::Printer(false);
+
+	auto context = panther::Context(panther::createDefaultDiagnosticCallback(printer), panther::Context::Config{
+		.numThreads     = num_threads,
+		.maxNumErrors   = 1,
+		.memoryMapFiles = config.memory_map_files,
+
+		// relative to the corpus size so only "one_huge_file" is split into chunks (at any `--size-mb=`), as the
+		// 		defaults are larger than the default corpus size
+		.parallelTokenizeThreshold = std::max(config.corpus_size / 2, size_t(1)),
+		.parallelTokenizeChunkSize = std::max(config.corpus_size / 16, size_t(64 * 1024)),
+	});
+
+	// starting the threads is not part of any phase
+	if(context.isMultiThreaded()){ context.startupThreads(); }
+
+	auto finish = [&]() noexcept -> void {
+		if(context.isMultiThreaded() && context.threadsRunning()){ context.shutdownThreads(); }
+	};
+
+
+	const auto load_start = std::chrono::steady_clock::now();
+
+	context.loadFiles(corpus.files);
+	if(context.isMultiThreaded()){ context.waitForAllTasks(); }
+
+	const auto load_end = std::chrono::steady_clock::now();
+
+	if(context.errored()){
+		finish();
+		return std::nullopt;
+	}
+
+
+	const size_t num_allocations_before_tokenize = num_allocations.load();
+	const auto tokenize_start = std::chrono::steady_clock::now();
+
+	context.tokenizeLoadedFiles();
+	if(context.isMultiThreaded()){ context.waitForAllTasks(); }
+
+	const auto tokenize_end = std::chrono::steady_clock::now();
+	const size_t num_tokenize_allocations = num_allocations.load() - num_allocations_before_tokenize;
+
+	if(context.errored()){
+		finish();
+		return std::nullopt;
+	}
+
+
+	size_t num_tokens = 0;
+	for(panther::Source::ID source_id : context.getSourceManager()){
+		num_tokens += context.getSourceManager().getSource(source_id).getTokenBuffer().size();
+	}
+
+	finish();
+
+	return RunResult{
+		.loadTime               = load_end - load_start,
+		.tokenizeTime           = tokenize_end - tokenize_start,
+		.numTokens              = num_tokens,
+		.numTokenizeAllocations = num_tokenize_allocations,
+	};
+};
+
+
+
+EVO_NODISCARD static auto get_default_thread_counts() noexcept -> std::vector<evo::uint> {
+	auto thread_counts = std::vector<evo::uint>{0};
+
+	const evo::uint optimal_num_threads = std::max(panther::Context::optimalNumThreads(), evo::uint(1));
+	for(evo::uint num_threads = 1; num_threads < optimal_num_threads; num_threads *= 2){
+		thread_counts.emplace_back(num_threads);
+	}
+	thread_counts.emplace_back(optimal_num_threads);
+
+	return thread_counts;
+};
+
+
+
+auto main(int argc, const char* argv[]) -> int {
+	auto args = std::vector<std::string_view>(argv, argv + argc);
+
+	auto config = Config{
+		.corpus_size      = 16 * 1024 * 1024,
+		.num_repetitions  = 3,
+		.thread_counts    = get_default_thread_counts(),
+		.memory_map_files = false,
+		.json             = false,
+	};
+
+	auto printer = pcit::core::Printer(
+		pcit::core::Printer::platformSupportsColor() == pcit::core::Printer::DetectResult::Yes
+	);
+
+
+	///////////////////////////////////
+	// parse args
+
+	for(std::string_view arg : args | std::views::drop(1)){
+		const auto arg_value = [&](std::string_view name) noexcept -> std::optional<std::string_view> {
+			if(arg.starts_with(name) == false){ return std::nullopt; }
+			return arg.substr(name.size());
+		};
+
+		if(arg == "--json"){
+			config.json = true;
+
+		}else if(arg == "--mmap"){
+			config.memory_map_files = true;
+
+		}else if(const std::optional<std::string_view> value = arg_value("--threads="); value.has_value()){
+			std::optional<std::vector<evo::uint>> thread_counts = parse_thread_counts(*value);
+			if(thread_counts.has_value() == false){
+				printer.printError(std::format("Invalid thread counts: \"{}\"\n", *value));
+				return EXIT_FAILURE;
+			}
+			config.thread_counts = std::move(*thread_counts);
+
+		}else if(const std::optional<std::string_view> value = arg_value("--size-mb="); value.has_value()){
+			const std::optional<size_t> size = parse_number(*value);
+			if(size.has_value() == false){
+				printer.printError(std::format("Invalid corpus size: \"{}\"\n", *value));
+				return EXIT_FAILURE;
+			}
+			config.corpus_size = *size * 1024 * 1024;
+
+		}else if(const std::optional<std::string_view> value = arg_value("--reps="); value.has_value()){
+			const std::optional<size_t> num_repetitions = parse_number(*value);
+			if(num_repetitions.has_value() == false){
+				printer.printError(std::format("Invalid number of repetitions: \"{}\"\n", *value));
+				return EXIT_FAILURE;
+			}
+			config.num_repetitions = *num_repetitions;
+
+		}else{
+			printer.printError(std::format("Unknown argument: \"{}\"\n", arg));
+			printer.printGray(
+				"Usage: pthr_bench [--json] [--mmap] [--threads=0,1,4,...] [--size-mb=<MB per corpus>] [--reps=<N>]\n"
+			);
+			return EXIT_FAILURE;
+		}
+	}
+
+
+	///////////////////////////////////
+	// generate corpora
+
+	const fs::path corpora_directory = fs::temp_directory_path() / "pthr_bench";
+
+	struct CorpusSpec{
+		std::string_view name;
+		bench::CorpusKind kind;
+		size_t numFiles;
+	};
+
+	// each is the same size, so the MB/s of each can be compared directly
+	static constexpr auto corpus_specs = std::to_array<CorpusSpec>({
+		CorpusSpec("identifiers",     bench::CorpusKind::Identifiers,    64),
+		CorpusSpec("comments",        bench::CorpusKind::Comments,       64),
+		CorpusSpec("number_literals", bench::CorpusKind::NumberLiterals, 64),
+		CorpusSpec("string_literals", bench::CorpusKind::StringLiterals, 64),
+		CorpusSpec("many_small_files", bench::CorpusKind::Mixed,         4096),
+		CorpusSpec("one_huge_file",   bench::CorpusKind::Mixed,          1),
+	});
+
+	auto corpora = std::vector<bench::Corpus>();
+	for(const CorpusSpec& corpus_spec : corpus_specs){
+		std::optional<bench::Corpus> corpus = bench::generateCorpus(
+			corpora_directory / corpus_spec.name,
+			corpus_spec.name,
+			corpus_spec.kind,
+			config.corpus_size,
+			std::min(corpus_spec.numFiles, std::max(config.corpus_size / 1024, size_t(1)))
+		);
+
+		if(corpus.has_value() == false){
+			printer.printError(
+				std::format("Failed to write corpus \"{}\" to {}\n", corpus_spec.name, corpora_directory.string())
+			);
+			return EXIT_FAILURE;
+		}
+
+		corpora.emplace_back(std::move(*corpus));
+	}
+
+
+	///////////////////////////////////
+	// run
+
+	if(config.json == false){
+		printer.printCyan("pthr_bench (Panther Compiler)\n");
+		printer.printGray("-----------------------------\n");
+		printer.printMagenta(std::format("v{}\n", pcit::core::version));
+		printer.printGray(
+			std::format("(fastest of {} runs, phase times in ms)\n", config.num_repetitions)
+		);
+
+		printer.printInfo(std::format(
+			"{:<18} {:>7} {:>6} {:>9} {:>9} {:>9} {:>10} {:>12}\n",
+			"corpus", "threads", "files", "load", "tokenize", "MB/s", "Mtokens/s", "allocs/token"
+		));
+	}
+
+	bool all_succeeded = true;
+
+	for(const bench::Corpus& corpus : corpora){
+		for(evo::uint num_threads : config.thread_counts){
+			std::optional<RunResult> fastest_run = std::nullopt;
+
+			for(size_t i = 0; i < config.num_repetitions; i+=1){
+				const std::optional<RunResult> run_result = run(config, corpus, num_threads);
+				if(run_result.has_value() == false){
+					fastest_run = std::nullopt;
+					break;
+				}
+
+				if(fastest_run.has_value() == false || run_result->tokenizeTime < fastest_run->tokenizeTime){
+					fastest_run = run_result;
+				}
+			}
+
+			if(fastest_run.has_value() == false){
+				printer.printError(std::format("Corpus \"{}\" errored ({} threads)\n", corpus.name, num_threads));
+				all_succeeded = false;
+				continue;
+			}
+
+			const double load_ms = fastest_run->loadTime.count() * 1000.0;
+			const double tokenize_ms = fastest_run->tokenizeTime.count() * 1000.0;
+			const double megabytes_per_second =
+				double(corpus.numBytes) / (1024.0 * 1024.0) / fastest_run->tokenizeTime.count();
+			const double tokens_per_second = double(fastest_run->numTokens) / fastest_run->tokenizeTime.count();
+			const double allocations_per_token =
+				double(fastest_run->numTokenizeAllocations) / double(std::max(fastest_run->numTokens, size_t(1)));
+
+			if(config.json){
+				printer.print(std::format(
+					"{{\"corpus\":\"{}\",\"threads\":{},\"files\":{},\"bytes\":{},\"tokens\":{},\"load_ms\":{:.3f},"
+					"\"tokenize_ms\":{:.3f},\"mb_per_second\":{:.2f},\"tokens_per_second\":{:.0f},"
+					"\"allocations\":{},\"allocations_per_token\":{:.6f},\"version\":\"{}\"}}\n",
+					corpus.name,
+					num_threads,
+					corpus.files.size(),
+					corpus.numBytes,
+					fastest_run->numTokens,
+					load_ms,
+					tokenize_ms,
+					megabytes_per_second,
+					tokens_per_second,
+					fastest_run->numTokenizeAllocations,
+					allocations_per_token,
+					pcit::core::version
+				));
+
+			}else{
+				printer.print(std::format(
+					"{:<18} {:>7} {:>6} {:>9.2f} {:>9.2f} {:>9.1f} {:>10.2f} {:>12.4f}\n",
+					corpus.name,
+					num_threads == 0 ? std::string("single") : std::to_string(num_threads),
+					corpus.files.size(),
+					load_ms,
+					tokenize_ms,
+					megabytes_per_second,
+					tokens_per_second / 1'000'000.0,
+					allocations_per_token
+				));
+			}
+		}
+	}
+
+
+	auto error_code = std::error_code();
+	fs::remove_all(corpora_directory, error_code);
+
+	return all_succeeded ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,259 @@
+//////////////////////////////////////////////////////////////////////
+//                                                                  //
+// Part of the PCIT-CPP, under the Apache License v2.0              //
+// You may not use this file except in compliance with the License. //
+// See `http://www.apache.org/licenses/LICENSE-2.0` for info        //
+//                                                                  //
+//////////////////////////////////////////////////////////////////////
+
+
+#include "./dumping.h"
+
+#include <bit>
+#include <fstream>
+
+#include "./printing.h"
+
+namespace pthr{
+
+	//////////////////////////////////////////////////////////////////////
+	// binary format
+	// 	(little-endian, and only depends on the tokens so it's the same on every machine)
+	//
+	// 	Header
+	// 	uint8_t[numTokens]              (kind of each token, the values of `panther::Token::Kind`, padded to 4 bytes)
+	// 	Location[numTokens]
+	// 	uint64_t[numValues]             (one for each token that has a value, in order)
+	// 	char[stringsSize]
+	//
+	// Ident, Intrinsic, Attribute, LiteralChar, and LiteralString tokens have a string value (the offset into the
+	// 		strings in the low 32 bits and the size in the high 32 bits), LiteralBool is 0 or 1, LiteralInt is the
+	// 		integer, and LiteralFloat is the bits of the F64. No other tokens have a value.
+
+	// change whenever the format changes (including when the values of `panther::Token::Kind` change)
+	static constexpr uint32_t FORMAT_VERSION = 1;
+	static constexpr std::string_view MAGIC = "PTKD";
+
+	struct Header{
+		char magic[4];
+		uint32_t formatVersion;
+		uint32_t numTokens;
+		uint32_t numValues;
+		uint64_t stringsSize;
+	};
+
+	struct Location{
+		uint32_t offset;
+		uint32_t length;
+		uint32_t line;
+		uint32_t collumn;
+	};
+
+
+	EVO_NODISCARD static constexpr auto get_file_extension(TokenDumper::Format format) noexcept -> std::string_view {
+		switch(format){
+			case TokenDumper::Format::Binary: return ".ptok";
+			case TokenDumper::Format::JSON:   return ".ndjson";
+		};
+
+		evo::debugFatalBreak("Unknown or unsupported token dumper format");
+	};
+
+	EVO_NODISCARD static constexpr auto kind_has_string_value(panther::Token::Kind kind) noexcept -> bool {
+		return kind == panther::Token::Kind::Ident || kind == panther::Token::Kind::Intrinsic
+			|| kind == panther::Token::Kind::Attribute
+			|| kind == panther::Token::Kind::LiteralChar || kind == panther::Token::Kind::LiteralString;
+	};
+
+
+	template<class T>
+	static auto append_little_endian(std::string& buffer, T value) noexcept -> void {
+		static_assert(std::is_unsigned_v<T>);
+
+		for(size_t i = 0; i < sizeof(T); i+=1){
+			buffer += char(uint8_t(value >> (i * 8)));
+		}
+	};
+
+
+
+	TokenDumper::TokenDumper(Format _format, const fs::path& _output_directory) noexcept
+		: format(_format), output_directory(_output_directory) {
+		auto ec = std::error_code();
+		this->working_directory = fs::weakly_canonical(fs::current_path(ec), ec);
+	};
+
+
+	auto TokenDumper::dump(const panther::Source& source) noexcept -> void {
+		const fs::path shard_path = this->getShardPath(source);
+
+		{
+			const auto lock = std::lock_guard(this->shard_paths_mutex);
+
+			const auto [owner, is_new_shard] = this->shard_owners.try_emplace(shard_path.string(), source.getID());
+			if(is_new_shard == false && owner->second != source.getID()){
+				this->colliding_shard_paths.emplace_back(shard_path);
+				return;
+			}
+		}
+
+		const std::string shard = this->format == Format::Binary ? encode_binary(source) : encode_json(source);
+
+		const bool wrote_shard = [&]() noexcept -> bool {
+			auto ec = std::error_code();
+			fs::create_directories(shard_path.parent_path(), ec);
+			if(ec && fs::is_directory(shard_path.parent_path(), ec) == false){ return false; }
+
+			auto file = std::ofstream(shard_path, std::ios::binary | std::ios::trunc);
+			if(file.is_open() == false){ return false; }
+
+			file.write(shard.data(), std::streamsize(shard.size()));
+			return file.good();
+		}();
+
+		if(wrote_shard){
+			this->num_dumped += 1;
+		}else{
+			const auto lock = std::lock_guard(this->shard_paths_mutex);
+			this->failed_shard_paths.emplace_back(shard_path);
+		}
+	};
+
+
+	auto TokenDumper::getShardPath(const panther::Source& source) const noexcept -> fs::path {
+		// canonical so a file matched through different paths always gets the same shard
+		auto ec = std::error_code();
+		fs::path source_path = fs::weakly_canonical(source.getLocationPath(), ec);
+		if(ec){ source_path = fs::absolute(source.getLocationPath(), ec).lexically_normal(); }
+
+		const fs::path relative_source_path = source_path.lexically_relative(this->working_directory);
+		const bool is_in_working_directory = relative_source_path.empty() == false
+			&& *relative_source_path.begin() != "..";
+
+		fs::path shard_path = this->output_directory;
+		if(is_in_working_directory){
+			shard_path /= relative_source_path;
+
+		}else{
+			shard_path /= "_external";
+
+			// the root name is kept so the same path on different drives doesn't collide (only on Windows)
+			std::string root_name = source_path.root_name().string();
+			std::erase_if(root_name, [](char character) noexcept -> bool {
+				return character == ':' || character == '/' || character == '\\';
+			});
+			if(root_name.empty() == false){ shard_path /= root_name; }
+
+			shard_path /= source_path.relative_path();
+		}
+		shard_path += get_file_extension(this->format);
+		return shard_path;
+	};
+
+
+
+	auto TokenDumper::encode_binary(const panther::Source& source) noexcept -> std::string {
+		const panther::TokenBuffer& token_buffer = source.getTokenBuffer();
+
+		auto values = std::string();
+		auto strings = std::string();
+		uint32_t num_values = 0;
+
+		for(panther::Token::ID token_id : token_buffer){
+			const panther::Token::Kind kind = token_buffer.getKind(token_id);
+			if(panther::Token::kindHasValue(kind) == false){ continue; }
+
+			const panther::Token token = token_buffer[token_id];
+			num_values += 1;
+
+			switch(kind){
+				break; case panther::Token::Kind::LiteralBool:  append_little_endian(values, uint64_t(token.getBool()));
+				break; case panther::Token::Kind::LiteralInt:   append_little_endian(values, token.getInt());
+				break; case panther::Token::Kind::LiteralFloat: {
+					append_little_endian(values, std::bit_cast<uint64_t>(token.getFloat()));
+				}
+
+				break; default: {
+					const std::string_view str = token.getString();
+					append_little_endian(values, uint64_t(strings.size()) | (uint64_t(str.size()) << 32));
+					strings += str;
+				}
+			};
+		}
+
+
+		auto output = std::string();
+		output.reserve(
+			sizeof(Header) + token_buffer.size() * (sizeof(uint8_t) + sizeof(Location)) + 3
+				+ values.size() + strings.size()
+		);
+
+		output += MAGIC;
+		append_little_endian(output, FORMAT_VERSION);
+		append_little_endian(output, uint32_t(token_buffer.size()));
+		append_little_endian(output, num_values);
+		append_little_endian(output, uint64_t(strings.size()));
+
+		for(panther::Token::ID token_id : token_buffer){
+			output += char(token_buffer.getKind(token_id));
+		}
+		output.append((4 - token_buffer.size() % 4) % 4, '\0');
+
+		for(panther::Token::ID token_id : token_buffer){
+			const panther::Token::Location& location = token_buffer.getLocation(token_id);
+			const panther::Source::LineAndCollumn line_and_collumn = source.getLineAndCollumn(location.offset);
+
+			append_little_endian(output, location.offset);
+			append_little_endian(output, location.length);
+			append_little_endian(output, line_and_collumn.line);
+			append_little_endian(output, line_and_collumn.collumn);
+		}
+
+		output += values;
+		output += strings;
+
+		return output;
+	};
+
+
+	auto TokenDumper::encode_json(const panther::Source& source) noexcept -> std::string {
+		const panther::TokenBuffer& token_buffer = source.getTokenBuffer();
+
+		auto output = std::string();
+		const auto out = std::back_inserter(output);
+
+		for(panther::Token::ID token_id : token_buffer){
+			const panther::Token token = token_buffer[token_id];
+			const panther::Token::Location& location = token.getLocation();
+			const panther::Source::LineAndCollumn line_and_collumn = source.getLineAndCollumn(location.offset);
+
+			std::format_to(
+				out,
+				"{{\"kind\":\"{}\",\"line\":{},\"column\":{},\"offset\":{},\"length\":{}",
+				escapeJSONString(panther::Token::printKind(token.getKind())),
+				line_and_collumn.line,
+				line_and_collumn.collumn,
+				location.offset,
+				location.length
+			);
+
+			switch(token.getKind()){
+				break; case panther::Token::Kind::LiteralBool:  std::format_to(out, ",\"value\":{}", token.getBool());
+				break; case panther::Token::Kind::LiteralInt:   std::format_to(out, ",\"value\":{}", token.getInt());
+				break; case panther::Token::Kind::LiteralFloat: std::format_to(out, ",\"value\":{}", token.getFloat());
+
+				break; default: {
+					if(kind_has_string_value(token.getKind())){
+						std::format_to(out, ",\"value\":\"{}\"", escapeJSONString(token.getString()));
+					}
+				}
+			};
+
+			output += "}\n";
+		}
+
+		return output;
+	};
+
+
+};
\ No newline at end of file
@@ -0,0 +1,81 @@
+//////////////////////////////////////////////////////////////////////
+//                                                                  //
+// Part of the PCIT-CPP, under the Apache License v2.0              //
+// You may not use this file except in compliance with the License. //
+// See `http://www.apache.org/licenses/LICENSE-2.0` for info        //
+//                                                                  //
+//////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <filesystem>
+namespace fs = std::filesystem;
+
+#include <Evo.h>
+
+#include <Panther.h>
+namespace panther = pcit::panther;
+
+
+namespace pthr{
+
+
+	// Writes the tokens of each source to a file of its own (a shard) in the output directory, at the path of the
+	// 		source relative to the working directory (files outside of it go under "_external/<root name>/" with
+	// 		their path from the root, so they don't collide with the ones inside of it).
+	// Each source is meant to be dumped by the worker that tokenized it as soon as it's done (through
+	// 		`panther::Context::Config::sourceTokenizedCallback`). A shard only depends on the tokens of its source,
+	// 		so the output is the same no matter the number of threads or the order the sources finished in.
+	class TokenDumper{
+		public:
+			enum class Format{
+				Binary, // ".ptok" (see the format in dumping.cpp)
+				JSON,   // ".ndjson" (one object per line for each token)
+			};
+
+		public:
+			TokenDumper(Format _format, const fs::path& _output_directory) noexcept;
+			~TokenDumper() = default;
+
+			// thread-safe (as long as each source is only dumped by one thread at a time)
+			auto dump(const panther::Source& source) noexcept -> void;
+
+			EVO_NODISCARD auto getShardPath(const panther::Source& source) const noexcept -> fs::path;
+
+			// number of shards written (and the paths of the ones that couldn't be) since the last call
+			// 	(no sources can be being dumped)
+			EVO_NODISCARD auto takeNumDumped() noexcept -> size_t { return this->num_dumped.exchange(0); };
+			EVO_NODISCARD auto takeFailedShardPaths() noexcept -> std::vector<fs::path> {
+				return std::exchange(this->failed_shard_paths, std::vector<fs::path>());
+			};
+
+			// paths of the shards that more than one source resolved to since the last call (not written for any
+			// 	source but the first one dumped to it, as which one that is depends on the order they finished in)
+			// 	(no sources can be being dumped)
+			EVO_NODISCARD auto takeCollidingShardPaths() noexcept -> std::vector<fs::path> {
+				return std::exchange(this->colliding_shard_paths, std::vector<fs::path>());
+			};
+
+		private:
+			EVO_NODISCARD static auto encode_binary(const panther::Source& source) noexcept -> std::string;
+			EVO_NODISCARD static auto encode_json(const panther::Source& source) noexcept -> std::string;
+
+		private:
+			Format format;
+			fs::path output_directory;
+			fs::path working_directory; // canonical
+
+			std::atomic<size_t> num_dumped = 0;
+			std::vector<fs::path> failed_shard_paths{};
+			std::vector<fs::path> colliding_shard_paths{};
+			std::unordered_map<std::string, panther::Source::ID> shard_owners{}; // key is the shard path
+			std::mutex shard_paths_mutex{};
+	};
+
+
+};
\ No newline at end of file
@@ -7,8 +7,13 @@
 //////////////////////////////////////////////////////////////////////
 
 
+#include <algorithm>
+#include <charconv>
+#include <csignal>
 #include <iostream>
 #include <filesystem>
+#include <ranges>
+#include <thread>
 namespace fs = std::filesystem;
 
 #include <Evo.h>
@@ -16,7 +21,10 @@ namespace fs = std::filesystem;
 #include <Panther.h>
 namespace panther = pcit::panther;
 
+#include "./dumping.h"
 #include "./printing.h"
+#include "./profiling.h"
+#include "./watching.h"
 
 
 #if defined(EVO_PLATFORM_WINDOWS)
@@ -36,14 +44,39 @@ namespace panther = pcit::panther;
 #endif
 
 
+// set when interrupted while watching, so it stops through the normal exit path
+static volatile std::sig_atomic_t stop_watching = 0;
+
+
 struct Config{
+	// `--target=<target>`
 	enum class Target{
-		PrintTokens,
+		PrintTokens,      // "print-tokens"
+		DumpTokensBinary, // "dump-tokens-binary" (see `pthr::TokenDumper`)
+		DumpTokensJSON,   // "dump-tokens-json"   (see `pthr::TokenDumper`)
 	} target;
 
+	enum class Mode{
+		Once,   // run the target and exit
+		Watch,  // after running the target, re-run it for files as they change until interrupted (`--watch`)
+		Server, // after running the target, re-run it for files that changed on each request from stdin (`--server`)
+	} mode;
+
 	bool verbose;
 	bool print_color;
-	evo::uint max_threads;
+	evo::uint max_threads; // 0 for single-threaded (`--threads=<num>`)
+
+	// if not empty, a Chrome trace of the run is written here and a summary is printed (`--profile=<path>`)
+	fs::path profile_path;
+
+	// print what the sources are using after running the target (`--memory`)
+	bool print_memory_usage;
+
+	// where the dump targets write the shard of each source (`--output=<path>`)
+	fs::path output_directory;
+
+	// files, directories, or globs of the files to load (any argument that isn't an option)
+	std::vector<fs::path> file_patterns;
 };
 
 
@@ -53,11 +86,20 @@ auto main(int argc, const char* argv[]) -> int {
 
 	auto config = Config{
 		.target      = Config::Target::PrintTokens,
+		.mode        = Config::Mode::Once,
 		.verbose     = true,
 		.print_color = pcit::core::Printer::platformSupportsColor() == pcit::core::Printer::DetectResult::Yes,
 
 		.max_threads = panther::Context::optimalNumThreads(),
 		// .max_threads = 0,
+
+		.profile_path = fs::path(),
+
+		.print_memory_usage = false,
+
+		.output_directory = fs::path(),
+
+		.file_patterns = std::vector<fs::path>(),
 	};
 
 
@@ -72,6 +114,91 @@ auto main(int argc, const char* argv[]) -> int {
 
 	auto printer = pcit::core::Printer(config.print_color);
 
+	for(std::string_view arg : args | std::views::drop(1)){
+		if(arg == "--watch"){
+			config.mode = Config::Mode::Watch;
+
+		}else if(arg == "--server"){
+			config.mode = Config::Mode::Server;
+
+		}else if(arg == "--memory"){
+			config.print_memory_usage = true;
+
+		}else if(arg.starts_with("--profile=")){
+			config.profile_path = arg.substr(std::string_view("--profile=").size());
+
+			if(config.profile_path.empty()){
+				printer.printError("No path given for \"--profile=\"\n");
+				return EXIT_FAILURE;
+			}
+
+		}else if(arg.starts_with("--target=")){
+			const std::string_view target = arg.substr(std::string_view("--target=").size());
+
+			if(target == "print-tokens"){
+				config.target = Config::Target::PrintTokens;
+
+			}else if(target == "dump-tokens-binary"){
+				config.target = Config::Target::DumpTokensBinary;
+
+			}else if(target == "dump-tokens-json"){
+				config.target = Config::Target::DumpTokensJSON;
+
+			}else{
+				printer.printError(std::format("Unknown target: \"{}\"\n", target));
+				return EXIT_FAILURE;
+			}
+
+		}else if(arg.starts_with("--threads=")){
+			const std::string_view num_threads_str = arg.substr(std::string_view("--threads=").size());
+			const std::from_chars_result result = std::from_chars(
+				num_threads_str.data(), num_threads_str.data() + num_threads_str.size(), config.max_threads
+			);
+
+			if(result.ec != std::errc() || result.ptr != num_threads_str.data() + num_threads_str.size()){
+				printer.printError(std::format("Invalid number of threads: \"{}\"\n", num_threads_str));
+				return EXIT_FAILURE;
+			}
+
+		}else if(arg.starts_with("--output=")){
+			config.output_directory = arg.substr(std::string_view("--output=").size());
+
+			if(config.output_directory.empty()){
+				printer.printError("No path given for \"--output=\"\n");
+				return EXIT_FAILURE;
+			}
+
+		}else if(arg.starts_with("--")){
+			printer.printError(std::format("Unknown argument: \"{}\"\n", arg));
+			return EXIT_FAILURE;
+
+		}else{
+			config.file_patterns.emplace_back(arg);
+		}
+	}
+
+	if(config.file_patterns.empty()){
+		config.file_patterns = {"test.pthr", "test2.pthr"};
+	}
+
+	auto token_dumper = std::optional<pthr::TokenDumper>();
+	switch(config.target){
+		break; case Config::Target::PrintTokens: break;
+		break; case Config::Target::DumpTokensBinary: case Config::Target::DumpTokensJSON: {
+			if(config.output_directory.empty()){
+				printer.printError("The target needs an output directory (\"--output=<path>\")\n");
+				return EXIT_FAILURE;
+			}
+
+			token_dumper.emplace(
+				config.target == Config::Target::DumpTokensBinary
+					? pthr::TokenDumper::Format::Binary
+					: pthr::TokenDumper::Format::JSON,
+				config.output_directory
+			);
+		}
+	};
+
 
 	if(config.verbose){
 		printer.printCyan("pthr (Panther Compiler)\n");
@@ -79,21 +206,73 @@ auto main(int argc, const char* argv[]) -> int {
 		printer.printMagenta(std::format("v{}\n", pcit::core::version));
 
 		switch(config.target){
-			break; case Config::Target::PrintTokens: printer.printMagenta("Target: PrintTokens\n");
+			break; case Config::Target::PrintTokens:      printer.printMagenta("Target: PrintTokens\n");
+			break; case Config::Target::DumpTokensBinary: printer.printMagenta("Target: DumpTokensBinary\n");
+			break; case Config::Target::DumpTokensJSON:   printer.printMagenta("Target: DumpTokensJSON\n");
 			break; default: evo::debugFatalBreak("Unknown or unsupported config target");
 		};
+
+		switch(config.mode){
+			break; case Config::Mode::Once:   break;
+			break; case Config::Mode::Watch:  printer.printMagenta("Mode: Watch\n");
+			break; case Config::Mode::Server: printer.printMagenta("Mode: Server\n");
+		};
 	}
 
 
 	const evo::uint num_threads = config.max_threads;
 
+	// the dump targets are run for each source by the worker that tokenized it, as soon as it's done
+	// 	(instead of one source after another once all of them are)
+	auto source_tokenized_callback = panther::Context::SourceTokenizedCallback();
+	if(token_dumper.has_value()){
+		source_tokenized_callback = [&](
+			const panther::Context& tokenizing_context, panther::Source::ID source_id
+		) noexcept -> void {
+			token_dumper->dump(tokenizing_context.getSourceManager().getSource(source_id));
+		};
+	}
+
 	auto context = panther::Context(panther::createDefaultDiagnosticCallback(printer), panther::Context::Config{
-		.numThreads   = num_threads,
-		.maxNumErrors = 1,
+		.numThreads     = num_threads,
+
+		// when watching, every changed file is reloaded even if another one has errors
+		// 	(hitting the fail condition would skip reloading the rest of them)
+		.maxNumErrors   = config.mode == Config::Mode::Once ? 1 : std::numeric_limits<evo::uint>::max(),
+
+		// files that are watched have to be read (the data of a mapped file would change along with the file)
+		.memoryMapFiles = config.mode == Config::Mode::Once,
+
+		.collectProfileData = config.profile_path.empty() == false,
+
+		// nothing is edited or reloaded when only running once, so the data isn't needed after tokenizing
+		.releaseSourceData = config.mode == Config::Mode::Once,
+
+		.sourceTokenizedCallback = std::move(source_tokenized_callback),
 	});
 
 
 	auto exit = [&]() noexcept -> void {
+		if(config.profile_path.empty() == false){
+			const panther::ProfileData profile_data = context.getProfileData();
+
+			if(pthr::writeChromeTrace(profile_data, context.getSourceManager(), config.profile_path)){
+				if(config.verbose){
+					printer.printMagenta(std::format("Wrote profile trace to \"{}\"\n", config.profile_path.string()));
+				}
+			}else{
+				printer.printError(
+					std::format("Failed to write profile trace to \"{}\"\n", config.profile_path.string())
+				);
+			}
+
+			pthr::printProfileSummary(printer, profile_data);
+		}
+
+		if(config.print_memory_usage){
+			pthr::printMemoryUsage(printer, context.getMemoryUsage(), context.getSourceManager());
+		}
+
 		if(context.isMultiThreaded() && context.threadsRunning()){
 			context.shutdownThreads();
 		}
@@ -123,64 +302,183 @@ auto main(int argc, const char* argv[]) -> int {
 
 
 	///////////////////////////////////
-	// load files
+	// load and tokenize files
 
-	context.loadFiles({
-		"test.pthr",
-		"test2.pthr",
-	});
+	context.loadAndTokenizeFilesMatching(config.file_patterns);
 
 	if(context.isMultiThreaded()){
 		context.waitForAllTasks();
 	}
 
-	if(context.errored()){
-		if(config.verbose){ printer.printError("Encountered an error loading files\n"); }
+	auto run_target = [&](panther::Source::ID source_id) noexcept -> void {
+		const panther::Source& source = context.getSourceManager().getSource(source_id);
 
-		exit();
-		return EXIT_FAILURE;
-	}
+		switch(config.target){
+			break; case Config::Target::PrintTokens:      pthr::printTokens(printer, source);
+			break; case Config::Target::DumpTokensBinary: token_dumper->dump(source);
+			break; case Config::Target::DumpTokensJSON:   token_dumper->dump(source);
+			break; default: evo::debugFatalBreak("Unknown or unsupported config target");
+		};
+	};
 
+	// returns false if any shards couldn't be written
+	auto report_dumped_tokens = [&]() noexcept -> bool {
+		if(token_dumper.has_value() == false){ return true; }
 
-	if(config.verbose){ printer.printSuccess("Successfully loaded all files\n"); }
+		const size_t num_dumped = token_dumper->takeNumDumped();
+		std::vector<fs::path> failed_shard_paths = token_dumper->takeFailedShardPaths();
+		std::ranges::sort(failed_shard_paths); // in whatever order the workers finished
 
+		for(const fs::path& failed_shard_path : failed_shard_paths){
+			printer.printError(std::format("Failed to write tokens to \"{}\"\n", failed_shard_path.string()));
+		}
 
+		std::vector<fs::path> colliding_shard_paths = token_dumper->takeCollidingShardPaths();
+		std::ranges::sort(colliding_shard_paths);
 
-	///////////////////////////////////
-	// tokenize
+		for(const fs::path& colliding_shard_path : colliding_shard_paths){
+			printer.printError(
+				std::format("Tokens of more than one file resolve to \"{}\"\n", colliding_shard_path.string())
+			);
+		}
 
-	context.tokenizeLoadedFiles();
+		if(config.verbose && num_dumped > 0){
+			printer.printMagenta(
+				std::format(
+					"Dumped tokens of {} file{} to \"{}\"\n",
+					num_dumped,
+					num_dumped == 1 ? "" : "s",
+					config.output_directory.string()
+				)
+			);
+		}
+
+		return failed_shard_paths.empty() && colliding_shard_paths.empty();
+	};
 
-	if(context.isMultiThreaded()){
-		context.waitForAllTasks();
-	}
 
 	if(context.errored()){
-		if(config.verbose){ printer.printError("Encountered an error tokenizing files\n"); }
+		if(config.verbose){ printer.printError("Encountered an error loading / tokenizing files\n"); }
+
+	}else{
+		if(config.verbose){ printer.printSuccess("Successfully loaded and tokenized all files\n"); }
+
+		if(token_dumper.has_value() == false){
+			for(panther::Source::ID source_id : context.getSourceManager()){
+				run_target(source_id);
+			}
+		}
+	}
+
+	// the sources that did tokenize were already dumped (even if others errored)
+	const bool dumped_all_tokens = report_dumped_tokens();
 
+	if(config.mode == Config::Mode::Once){
 		exit();
-		return EXIT_FAILURE;
+		return context.errored() == false && dumped_all_tokens ? EXIT_SUCCESS : EXIT_FAILURE;
 	}
 
 
-	if(config.verbose){ printer.printSuccess("Successfully tokenized all files\n"); }
+	///////////////////////////////////
+	// watch / server
+	// 	(the context, its threads, and every source stay loaded, so only files that changed are re-tokenized, and
+	// 	 only the part of each of them that changed)
 
-	if(config.target == Config::Target::PrintTokens){
-		const panther::SourceManager& source_manager = context.getSourceManager();
+	auto file_watcher = pthr::FileWatcher(context.getSourceManager());
 
-		for(panther::Source::ID source_id : source_manager){
-			const panther::Source& source = source_manager.getSource(source_id);
+	auto rerun_changed_files = [&]() noexcept -> void {
+		// any errors have already been reported
+		context.clearErrors();
 
-			pthr::printTokens(printer, source);
+		// files created since that match the patterns (new sources are dumped by the workers)
+		context.loadAndTokenizeNewFilesMatching(config.file_patterns);
+		if(context.isMultiThreaded()){
+			context.waitForAllTasks();
 		}
+		const std::vector<panther::Source::ID> new_sources = file_watcher.watchNewSources();
+
+		const pthr::FileWatcher::Changes changes = file_watcher.getChanges();
+
+		if(config.verbose){
+			for(panther::Source::ID source_id : changes.removed){
+				printer.printMagenta(
+					std::format(
+						"File \"{}\" was removed\n",
+						context.getSourceManager().getSource(source_id).getLocationAsString()
+					)
+				);
+			}
+		}
+
+		if(changes.changed.empty() == false){
+			context.reloadSourceFiles(changes.changed);
+
+			if(context.isMultiThreaded()){
+				context.waitForAllTasks();
+			}
+		}
+
+		if(context.errored()){
+			if(config.verbose){ printer.printError("Encountered an error reloading / tokenizing files\n"); }
+			std::ignore = report_dumped_tokens();
+			return;
+		}
+
+		if(token_dumper.has_value() == false){
+			for(panther::Source::ID source_id : new_sources){
+				run_target(source_id);
+			}
+		}
+
+		// re-tokenized sources aren't dumped by the workers (`sourceTokenizedCallback` is only for new sources)
+		for(panther::Source::ID source_id : changes.changed){
+			run_target(source_id);
+		}
+
+		std::ignore = report_dumped_tokens();
+	};
+
+
+	if(config.mode == Config::Mode::Watch){
+		static constexpr auto POLL_INTERVAL = std::chrono::milliseconds(100);
+
+		if(config.verbose){ printer.printMagenta("Watching files for changes... (interrupt to stop)\n"); }
+
+		// so stopping goes through `exit()` (writing the profile / memory usage and shutting down the threads)
+		std::signal(SIGINT, [](int) -> void { stop_watching = 1; });
+		std::signal(SIGTERM, [](int) -> void { stop_watching = 1; });
+
+		while(stop_watching == 0){
+			std::this_thread::sleep_for(POLL_INTERVAL);
+			rerun_changed_files();
+
+			// so the output shows up while watching even if stdout isn't a terminal
+			std::fflush(stdout);
+		};
 
 		exit();
 		return EXIT_SUCCESS;
 	}
 
 
-	///////////////////////////////////
-	// done
+	// Each line read from stdin is a request:
+	// 	"build": run the target for every file that changed since the last request
+	// 	"quit":  exit (as does the end of stdin)
+	// The output of each request ends with a line of just "done" so a client can tell when it has got all of it
+	auto request = std::string();
+	while(std::getline(std::cin, request)){
+		if(request == "quit"){ break; }
+
+		if(request == "build"){
+			rerun_changed_files();
+		}else{
+			printer.printError(std::format("Unknown request: \"{}\"\n", request));
+		}
+
+		printer.print("done\n");
+		std::fflush(stdout);
+	};
 
-	evo::debugFatalBreak("Unknown or unsupported config target");
+	exit();
+	return EXIT_SUCCESS;
 }
\ No newline at end of file
@@ -15,6 +15,11 @@ namespace pthr{
 	auto printTokens(pcit::core::Printer& printer, const panther::Source& source) noexcept -> void {
 		const panther::TokenBuffer& token_buffer = source.getTokenBuffer();
 
+		// printing each part of every token separately is slow for large files, so it's all written at once
+		const bool started_buffering = printer.isBuffering() == false;
+		if(started_buffering){ printer.startBuffering(); }
+
+
 		///////////////////////////////////
 		// print header
 
@@ -34,64 +39,98 @@ namespace pthr{
 
 
 		///////////////////////////////////
-		// create location strings
+		// get locations
 
-		auto location_strings = std::vector<std::string>();
+		struct LineAndCollumn{
+			uint32_t line;
+			uint32_t collumn;
+		};
 
-		for(panther::Token::ID token_id : token_buffer){
-			const panther::Token& token = token_buffer[token_id];
-			const panther::Token::Location& location = token.getLocation();
+		auto locations = std::vector<LineAndCollumn>();
+		locations.reserve(token_buffer.size());
 
-			location_strings.emplace_back(std::format("<{}:{}>", location.lineStart, location.collumnStart));
-		}
+		size_t longest_location_string_length = 0;
 
-		const size_t longest_location_string_length = std::ranges::max_element(
-			location_strings,
-			[](const std::string& lhs, const std::string& rhs) noexcept -> bool {
-				return lhs.size() < rhs.size();
-			}
-		)->size();
+		for(panther::Token::ID token_id : token_buffer){
+			const panther::Token& token = token_buffer[token_id];
+			const panther::Source::Location location = token.getSourceLocation(source);
 
-		for(std::string& str : location_strings){
-			while(str.size() < longest_location_string_length){
-				str += ' ';
-			};
+			locations.emplace_back(location.lineStart, location.collumnStart);
 
-			str += ' ';
+			longest_location_string_length = std::max(
+				longest_location_string_length,
+				std::formatted_size("<{}:{}>", location.lineStart, location.collumnStart)
+			);
 		}
 
 
 		///////////////////////////////////
 		// print out tokens
 
+		// one string reused for every token (instead of formatting a new one each time)
+		auto str = std::string();
+		const auto out = std::back_inserter(str);
+
 		for(size_t i = 0; panther::Token::ID token_id : token_buffer){
 			const panther::Token& token = token_buffer[token_id];
-			
-			printer.printGray(location_strings[i]);
-			printer.printInfo(std::format("[{}]", token.getKind()));
 
+			str.clear();
+			std::format_to(out, "<{}:{}>", locations[i].line, locations[i].collumn);
+			str.append(longest_location_string_length - str.size() + 1, ' ');
+			printer.printGray(str);
 
-			const std::string data_str = [&]() noexcept {
-				switch(token.getKind()){
-					break; case panther::Token::Ident:         return std::format(" {}", token.getString());
-					break; case panther::Token::Intrinsic:     return std::format(" @{}", token.getString());
-					break; case panther::Token::Attribute:     return std::format(" #{}", token.getString());
+			str.clear();
+			std::format_to(out, "[{}]", token.getKind());
+			printer.printInfo(str);
 
-					break; case panther::Token::LiteralBool:   return std::format(" {}", token.getBool());
-					break; case panther::Token::LiteralInt:    return std::format(" {}", token.getInt());
-					break; case panther::Token::LiteralFloat:  return std::format(" {}", token.getFloat());
-					break; case panther::Token::LiteralChar:   return std::format(" \'{}\'", token.getString());
-					break; case panther::Token::LiteralString: return std::format(" \"{}\"", token.getString());
 
-					break; default: return std::string();
-				};
-			}();
+			str.clear();
+			switch(token.getKind()){
+				break; case panther::Token::Ident:         std::format_to(out, " {}", token.getString());
+				break; case panther::Token::Intrinsic:     std::format_to(out, " @{}", token.getString());
+				break; case panther::Token::Attribute:     std::format_to(out, " #{}", token.getString());
 
-			printer.printMagenta(data_str + '\n');
+				break; case panther::Token::LiteralBool:   std::format_to(out, " {}", token.getBool());
+				break; case panther::Token::LiteralInt:    std::format_to(out, " {}", token.getInt());
+				break; case panther::Token::LiteralFloat:  std::format_to(out, " {}", token.getFloat());
+				break; case panther::Token::LiteralChar:   std::format_to(out, " \'{}\'", token.getString());
+				break; case panther::Token::LiteralString: std::format_to(out, " \"{}\"", token.getString());
+
+				break; default: break;
+			};
+			str += '\n';
+
+			printer.printMagenta(str);
 
 			i += 1;
 		}
-		
+
+		if(started_buffering){ printer.stopBuffering(); }
+	};
+
+
+	auto escapeJSONString(std::string_view str) noexcept -> std::string {
+		auto escaped = std::string();
+		escaped.reserve(str.size());
+
+		for(char character : str){
+			switch(character){
+				break; case '"':  escaped += "\\\"";
+				break; case '\\': escaped += "\\\\";
+				break; case '\n': escaped += "\\n";
+				break; case '\r': escaped += "\\r";
+				break; case '\t': escaped += "\\t";
+				break; default: {
+					if(uint8_t(character) < 0x20){
+						escaped += std::format("\\u{:04x}", uint8_t(character));
+					}else{
+						escaped += character;
+					}
+				}
+			};
+		}
+
+		return escaped;
 	};
 
 
@@ -21,5 +21,8 @@ namespace pthr{
 
 	auto printTokens(pcit::core::Printer& printer, const panther::Source& source) noexcept -> void;
 
+	// escapes the characters that can't be in a JSON string (without the quotes around it)
+	EVO_NODISCARD auto escapeJSONString(std::string_view str) noexcept -> std::string;
+
 
 };
\ No newline at end of file
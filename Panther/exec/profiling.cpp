@@ -0,0 +1,237 @@
+//////////////////////////////////////////////////////////////////////
+//                                                                  //
+// Part of the PCIT-CPP, under the Apache License v2.0              //
+// You may not use this file except in compliance with the License. //
+// See `http://www.apache.org/licenses/LICENSE-2.0` for info        //
+//                                                                  //
+//////////////////////////////////////////////////////////////////////
+
+
+#include "./profiling.h"
+
+#include "./printing.h"
+
+#include <fstream>
+#include <ranges>
+
+namespace pthr{
+
+
+	// the thread of anything external to the workers is shown after the last worker
+	EVO_NODISCARD static auto get_trace_thread(const panther::ProfileData& profile_data, uint32_t thread) noexcept
+	-> size_t {
+		if(thread == panther::ProfileData::EXTERNAL_THREAD){ return profile_data.threadCounters.size() - 1; }
+		return thread;
+	};
+
+
+	EVO_NODISCARD static auto nanoseconds_to_milliseconds(uint64_t nanoseconds) noexcept -> double {
+		return double(nanoseconds) / 1'000'000.0;
+	};
+
+
+
+	auto writeChromeTrace(
+		const panther::ProfileData& profile_data, const panther::SourceManager& source_manager, const fs::path& path
+	) noexcept -> bool {
+		auto file = std::ofstream(path, std::ios::binary);
+		if(file.is_open() == false){ return false; }
+
+		file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+		// written before every entry but the first (so there's never a trailing comma, even with no events)
+		std::string_view separator = "\n";
+
+		for(size_t i = 0; i < profile_data.threadCounters.size(); i+=1){
+			const std::string thread_name = i + 1 == profile_data.threadCounters.size()
+				? std::string("external")
+				: std::format("worker {}", i);
+
+			file << separator;
+			separator = ",\n";
+
+			file << std::format(
+				"{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":{},\"args\":{{\"name\":\"{}\"}}}}",
+				i,
+				thread_name
+			);
+		}
+
+		// times in the trace event format are in microseconds
+		for(const panther::ProfileData::Event& event : profile_data.events){
+			const std::string_view name = event.kind == panther::ProfileData::EventKind::LockWait
+				? panther::ProfileData::printLock(event.lock)
+				: panther::ProfileData::printEventKind(event.kind);
+
+			file << separator;
+			separator = ",\n";
+
+			file << std::format(
+				"{{\"name\":\"{}\",\"cat\":\"{}\",\"ph\":\"X\",\"pid\":0,\"tid\":{},"
+				"\"ts\":{:.3f},\"dur\":{:.3f},\"args\":{{",
+				name,
+				event.kind == panther::ProfileData::EventKind::LockWait ? "lock" : "task",
+				get_trace_thread(profile_data, event.thread),
+				double(event.start) / 1000.0,
+				double(event.end - event.start) / 1000.0
+			);
+
+			if(event.sourceID != panther::ProfileData::NO_SOURCE){
+				const panther::Source& source = source_manager.getSource(panther::Source::ID(event.sourceID));
+				file << std::format("\"source\":\"{}\"", escapeJSONString(source.getLocationAsString()));
+
+				if(event.kind == panther::ProfileData::EventKind::TokenizeChunk){
+					file << std::format(",\"chunk\":{}", event.chunkIndex);
+				}
+			}
+
+			file << "}}";
+		}
+
+		file << "\n]}\n";
+
+		return file.good();
+	};
+
+
+
+	auto printProfileSummary(pcit::core::Printer& printer, const panther::ProfileData& profile_data) noexcept -> void {
+		printer.printCyan("Profile:\n");
+
+		printer.printGray("  thread   | tasks    | busy (ms)  | idle (ms)  | tokens\n");
+		for(size_t i = 0; i < profile_data.threadCounters.size(); i+=1){
+			const panther::ProfileData::Counters& counters = profile_data.threadCounters[i];
+			if(counters.numTasks == 0 && counters.tokensProduced == 0){ continue; }
+
+			const std::string thread_name = i + 1 == profile_data.threadCounters.size()
+				? std::string("external")
+				: std::format("worker {}", i);
+
+			printer.print(
+				std::format(
+					"  {:<8} | {:<8} | {:<10.3f} | {:<10.3f} | {}\n",
+					thread_name,
+					counters.numTasks,
+					nanoseconds_to_milliseconds(counters.taskTime),
+					nanoseconds_to_milliseconds(counters.idleTime),
+					counters.tokensProduced
+				)
+			);
+		}
+
+
+		const panther::ProfileData::Counters& total = profile_data.totalCounters;
+
+		const double total_time = nanoseconds_to_milliseconds(profile_data.endTime);
+		printer.print(std::format("  total time:      {:.3f}ms\n", total_time));
+		printer.print(std::format("  bytes loaded:    {}\n", total.bytesLoaded));
+		printer.print(std::format("  tokens produced: {}\n", total.tokensProduced));
+
+		if(total.numTasks > 0){
+			printer.print(
+				std::format(
+					"  avg queue wait:  {:.3f}ms\n",
+					nanoseconds_to_milliseconds(total.queueWaitTime) / double(total.numTasks)
+				)
+			);
+		}
+
+		printer.print(
+			std::format(
+				"  diagnostics:     {} ({:.3f}ms in the callback)\n",
+				total.numDiagnostics,
+				nanoseconds_to_milliseconds(total.diagnosticCallbackTime)
+			)
+		);
+
+		for(size_t i = 0; i < panther::ProfileData::NUM_LOCKS; i+=1){
+			const panther::ProfileData::LockCounters& lock_counters = total.locks[i];
+
+			printer.print(
+				std::format(
+					"  {} lock: contended {} times ({:.3f}ms waiting)\n",
+					panther::ProfileData::printLock(panther::ProfileData::Lock(i)),
+					lock_counters.numContended,
+					nanoseconds_to_milliseconds(lock_counters.waitTime)
+				)
+			);
+		}
+	};
+
+
+
+	EVO_NODISCARD static auto bytes_to_kibibytes(size_t bytes) noexcept -> double {
+		return double(bytes) / 1024.0;
+	};
+
+
+	auto printMemoryUsage(
+		pcit::core::Printer& printer,
+		const panther::Context::MemoryUsage& memory_usage,
+		const panther::SourceManager& source_manager
+	) noexcept -> void {
+		static constexpr size_t MAX_NUM_SOURCES_PRINTED = 10;
+
+		printer.printCyan("Memory usage:\n");
+
+		const panther::Source::MemoryUsage& total = memory_usage.sourceManager.total;
+
+		printer.print(std::format("  source data:       {:.1f}KiB\n", bytes_to_kibibytes(total.ownedData)));
+		printer.print(std::format("  mapped data:       {:.1f}KiB\n", bytes_to_kibibytes(total.mappedData)));
+		printer.print(std::format("  line starts:       {:.1f}KiB\n", bytes_to_kibibytes(total.lineStarts)));
+		printer.print(std::format("  token kinds:       {:.1f}KiB\n", bytes_to_kibibytes(total.tokens.kinds)));
+		printer.print(std::format("  token locations:   {:.1f}KiB\n", bytes_to_kibibytes(total.tokens.locations)));
+		printer.print(std::format("  token values:      {:.1f}KiB\n", bytes_to_kibibytes(total.tokens.values)));
+		printer.print(
+			std::format("  token value index: {:.1f}KiB\n", bytes_to_kibibytes(total.tokens.valueBlocks))
+		);
+		printer.print(
+			std::format("  bracket index:     {:.1f}KiB\n", bytes_to_kibibytes(total.tokens.bracketIndex))
+		);
+		printer.print(
+			std::format("  source storage:    {:.1f}KiB\n", bytes_to_kibibytes(memory_usage.sourceManager.storage))
+		);
+		printer.print(
+			std::format(
+				"  interned strings:  {:.1f}KiB ({} strings, {:.1f}KiB table)\n",
+				bytes_to_kibibytes(memory_usage.stringInterner.arenaBytes),
+				memory_usage.stringInterner.numStrings,
+				bytes_to_kibibytes(memory_usage.stringInterner.tableBytes)
+			)
+		);
+		printer.print(
+			std::format("  total allocated:   {:.1f}KiB\n", bytes_to_kibibytes(memory_usage.totalAllocated()))
+		);
+
+
+		const std::vector<panther::Source::MemoryUsage>& sources = memory_usage.sourceManager.sources;
+		if(sources.empty()){ return; }
+
+		auto source_ids = std::vector<panther::Source::ID>(source_manager.begin(), source_manager.end());
+		const size_t num_sources_printed = std::min(source_ids.size(), MAX_NUM_SOURCES_PRINTED);
+
+		const auto uses_more_memory = [&](panther::Source::ID lhs, panther::Source::ID rhs) noexcept -> bool {
+			const auto get_total = [&](panther::Source::ID source_id) noexcept -> size_t {
+				return sources[source_id.get()].totalAllocated() + sources[source_id.get()].mappedData;
+			};
+			return get_total(lhs) > get_total(rhs);
+		};
+		std::ranges::partial_sort(source_ids, source_ids.begin() + num_sources_printed, uses_more_memory);
+
+		printer.printGray("  data (KiB)  | tokens (KiB) | source\n");
+		for(panther::Source::ID source_id : source_ids | std::views::take(num_sources_printed)){
+			const panther::Source::MemoryUsage& source_memory_usage = sources[source_id.get()];
+
+			printer.print(
+				std::format(
+					"  {:<11.1f} | {:<12.1f} | {}\n",
+					bytes_to_kibibytes(source_memory_usage.ownedData + source_memory_usage.mappedData),
+					bytes_to_kibibytes(source_memory_usage.tokens.total()),
+					source_manager.getSource(source_id).getLocationAsString()
+				)
+			);
+		}
+	};
+
+
+};
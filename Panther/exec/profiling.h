@@ -0,0 +1,43 @@
+//////////////////////////////////////////////////////////////////////
+//                                                                  //
+// Part of the PCIT-CPP, under the Apache License v2.0              //
+// You may not use this file except in compliance with the License. //
+// See `http://www.apache.org/licenses/LICENSE-2.0` for info        //
+//                                                                  //
+//////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+
+#include <filesystem>
+namespace fs = std::filesystem;
+
+#include <Evo.h>
+#include <PCIT_core.h>
+
+#include <Panther.h>
+namespace panther = pcit::panther;
+
+
+namespace pthr{
+
+
+	// Writes the events in the Chrome trace event format (open with `chrome://tracing` or Perfetto).
+	// Returns false if the file couldn't be written.
+	EVO_NODISCARD auto writeChromeTrace(
+		const panther::ProfileData& profile_data, const panther::SourceManager& source_manager, const fs::path& path
+	) noexcept -> bool;
+
+	// per-thread and total counters
+	auto printProfileSummary(pcit::core::Printer& printer, const panther::ProfileData& profile_data) noexcept -> void;
+
+	// totals of each category and the sources using the most memory
+	auto printMemoryUsage(
+		pcit::core::Printer& printer,
+		const panther::Context::MemoryUsage& memory_usage,
+		const panther::SourceManager& source_manager
+	) noexcept -> void;
+
+
+};
@@ -0,0 +1,79 @@
+//////////////////////////////////////////////////////////////////////
+//                                                                  //
+// Part of the PCIT-CPP, under the Apache License v2.0              //
+// You may not use this file except in compliance with the License. //
+// See `http://www.apache.org/licenses/LICENSE-2.0` for info        //
+//                                                                  //
+//////////////////////////////////////////////////////////////////////
+
+
+#include "./watching.h"
+
+namespace pthr{
+
+
+	FileWatcher::FileWatcher(const panther::SourceManager& _source_manager) noexcept
+		: source_manager(_source_manager) {
+		std::ignore = this->watchNewSources();
+	};
+
+
+	auto FileWatcher::watchNewSources() noexcept -> std::vector<panther::Source::ID> {
+		auto new_sources = std::vector<panther::Source::ID>();
+
+		// sources are never removed, so the new ones are always the ones after the last seen
+		const size_t num_sources = this->source_manager.numSources();
+		for(size_t i = this->num_sources_seen; i < num_sources; i+=1){
+			const auto source_id = panther::Source::ID(uint32_t(i));
+			const panther::Source& source = this->source_manager.getSource(source_id);
+			if(source.locationIsPath() == false){ continue; }
+
+			this->file_states.emplace_back(source_id, get_file_state(source.getLocationPath()));
+			new_sources.emplace_back(source_id);
+		}
+		this->num_sources_seen = num_sources;
+
+		return new_sources;
+	};
+
+
+	auto FileWatcher::getChanges() noexcept -> Changes {
+		auto changes = Changes();
+
+		for(auto& [source_id, file_state] : this->file_states){
+			const FileState new_file_state = get_file_state(this->source_manager.getSource(source_id).getLocationPath());
+			if(new_file_state == file_state){ continue; }
+
+			file_state = new_file_state;
+
+			if(new_file_state.exists){
+				changes.changed.emplace_back(source_id);
+			}else{
+				changes.removed.emplace_back(source_id);
+			}
+		}
+
+		return changes;
+	};
+
+
+	auto FileWatcher::get_file_state(const fs::path& path) noexcept -> FileState {
+		auto error_code = std::error_code();
+
+		if(fs::exists(path, error_code) == false && error_code.value() == 0){
+			return FileState(false, fs::file_time_type::min(), 0);
+		}
+
+		// a file that can't be read (for example in the middle of being replaced) is seen as having changed to
+		// 		empty, so it's checked again once it can be read
+		const fs::file_time_type last_write_time = fs::last_write_time(path, error_code);
+		if(error_code){ return FileState(true, fs::file_time_type::min(), 0); }
+
+		const uintmax_t size = fs::file_size(path, error_code);
+		if(error_code){ return FileState(true, fs::file_time_type::min(), 0); }
+
+		return FileState(true, last_write_time, size);
+	};
+
+
+};
@@ -0,0 +1,65 @@
+//////////////////////////////////////////////////////////////////////
+//                                                                  //
+// Part of the PCIT-CPP, under the Apache License v2.0              //
+// You may not use this file except in compliance with the License. //
+// See `http://www.apache.org/licenses/LICENSE-2.0` for info        //
+//                                                                  //
+//////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+
+#include <filesystem>
+namespace fs = std::filesystem;
+
+#include <Evo.h>
+
+#include <Panther.h>
+namespace panther = pcit::panther;
+
+
+namespace pthr{
+
+
+	// Finds the sources (that were loaded from files) whose files changed.
+	// Polls the last write time and size of each file, which works the same on every platform and is only a stat
+	// 		per file per poll. A changed file that happens to keep both is still reloaded the next time either changes,
+	// 		and a file that was touched without changing is not re-tokenized (`Context::reloadSourceFile` checks).
+	// A file that was removed stops being reported until it's created again (then it's reported as changed).
+	class FileWatcher{
+		public:
+			FileWatcher(const panther::SourceManager& source_manager) noexcept;
+			~FileWatcher() = default;
+
+			// starts watching the sources added since the last call (or since the watcher was created), and returns
+			// 	them (no sources can be being added)
+			auto watchNewSources() noexcept -> std::vector<panther::Source::ID>;
+
+			struct Changes{
+				std::vector<panther::Source::ID> changed;
+				std::vector<panther::Source::ID> removed;
+			};
+
+			// sources whose file changed or was removed since the last call (or since they started being watched)
+			EVO_NODISCARD auto getChanges() noexcept -> Changes;
+
+		private:
+			struct FileState{
+				bool exists;
+				fs::file_time_type lastWriteTime;
+				uintmax_t size;
+
+				EVO_NODISCARD auto operator==(const FileState&) const -> bool = default;
+			};
+
+			EVO_NODISCARD static auto get_file_state(const fs::path& path) noexcept -> FileState;
+
+		private:
+			const panther::SourceManager& source_manager;
+			std::vector<std::pair<panther::Source::ID, FileState>> file_states{};
+			size_t num_sources_seen = 0;
+	};
+
+
+};
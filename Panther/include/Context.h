@@ -9,8 +9,12 @@
 
 #pragma once
 
+#include <deque>
+#include <unordered_set>
 #include <queue>
 #include <memory>
+#include <chrono>
+#include <condition_variable>
 #include <filesystem>
 namespace fs = std::filesystem;
 
@@ -19,6 +23,7 @@ namespace fs = std::filesystem;
 
 #include "./SourceManager.h"
 #include "./diagnostics.h"
+#include "./ProfileData.h"
 
 
 namespace pcit::panther{
@@ -27,10 +32,69 @@ namespace pcit::panther{
 	class Context{
 		public:
 			using DiagnosticCallback = std::function<void(const Context&, const Diagnostic&)>;
+			using SourceTokenizedCallback = std::function<void(const Context&, Source::ID)>;
 
 			struct Config{
 				evo::uint numThreads   = 0;
 				evo::uint maxNumErrors = 1;
+
+				// memory-map loaded files instead of reading them into a string
+				// 	(no copy of the file and the data is shared through the OS page cache)
+				bool memoryMapFiles = false;
+
+				// When multi-threaded, sources at least this large (in bytes) are split into chunks of about
+				// 		`parallelTokenizeChunkSize` that are tokenized in parallel (0 to never split sources).
+				// 		The tokens are the same as tokenizing the source in one piece.
+				size_t parallelTokenizeThreshold = 32 * 1024 * 1024;
+				size_t parallelTokenizeChunkSize = 4 * 1024 * 1024;
+
+				// If set, tokens of sources are saved here and are loaded instead of re-tokenizing sources that have
+				// 		the exact same data (with the same version of the compiler). Created if it doesn't exist.
+				fs::path tokenCacheDirectory{};
+
+				// Record timings of every task, time spent waiting for tasks and contended locks, and counters such as
+				// 		bytes loaded and tokens produced (see `getProfileData()`).
+				// Costs a few clock reads per task (and nothing per token), so it can be used in release builds.
+				bool collectProfileData = false;
+
+				// Call the diagnostic callback as soon as a diagnostic is emitted (on whichever thread emitted it).
+				// Otherwise, each worker buffers the diagnostics it emits (without taking any locks) and they're all
+				// 		delivered from one thread when the task group ends (in `waitForAllTasks()`, or when the
+				// 		threads are shutdown), sorted by source and location so the output doesn't depend on the
+				// 		number of threads or how tasks were scheduled.
+				bool immediateDiagnostics = false;
+
+				// Once a source went through its last phase (tokenizing), free (or unmap) its data, leaving just the
+				// 		tokens and line starts. Token strings that were views into the data are interned first, and
+				// 		the token buffer is locked (which frees its spare capacity).
+				// The data is released when the task group ends (after the diagnostics were delivered, so they can
+				// 		still show the source code).
+				// Sources with released data can't be edited, and reloading one re-tokenizes all of it.
+				bool releaseSourceData = false;
+
+				// Only record the raw text of number literals (and text literals with escape sequences) when
+				// 		tokenizing, and decode their values when the tokens are first gotten from the TokenBuffer.
+				// Malformed literals are still reported while tokenizing, and the few literals that could be too large
+				// 		to fit are decoded straight away to check. Token streams always decode the values.
+				bool lazyLiteralValues = false;
+
+				// Called as soon as a task finished tokenizing a source (on the thread that ran it), so the tokens can
+				// 		be used while the rest of the sources are still being tokenized. Called at the same time for
+				// 		different sources, but only once for each, and before its data is released.
+				// Not called for sources that errored, or ones that are re-tokenized by edits and reloads.
+				SourceTokenizedCallback sourceTokenizedCallback{};
+			};
+
+			// in bytes
+			struct MemoryUsage{
+				SourceManager::MemoryUsage sourceManager;
+				core::StringInterner::MemoryUsage stringInterner;
+
+				// everything but the data of memory-mapped sources
+				EVO_NODISCARD auto totalAllocated() const noexcept -> size_t {
+					return this->sourceManager.total.totalAllocated() + this->sourceManager.storage
+						+ this->stringInterner.arenaBytes + this->stringInterner.tableBytes;
+				};
 			};
 
 		public:
@@ -57,7 +121,85 @@ namespace pcit::panther{
 			// 		load files through the Source Manager directly, (Call this->getSourceManager())
 			auto loadFiles(evo::ArrayProxy<fs::path> file_paths) noexcept -> void;
 
+			// Tokenizes every source that isn't tokenized yet (see `Source::isTokenized()`)
 			auto tokenizeLoadedFiles() noexcept -> void;
+
+			// Loads and tokenizes a number of files. Each file is tokenized as soon as it's loaded
+			// 		(instead of waiting for every file to be loaded first)
+			auto loadAndTokenizeFiles(evo::ArrayProxy<fs::path> file_paths) noexcept -> void;
+
+			// Loads every file that matches any of a number of patterns. Each pattern is either a file, a directory
+			// 		(every file with the extension `SOURCE_FILE_EXTENSION` in it or any of its subdirectories), or a
+			// 		glob where `*` and `?` match within a name and `**` matches any number of directories
+			// 		(for example "src/**/*.pthr"). Names starting with '.' are only matched explicitly.
+			// Directories are searched by tasks on the workers, and each file is loaded as soon as it's found (while
+			// 		the rest of the directories are still being searched). A file is only loaded once, even if it's
+			// 		matched more than once or by an earlier call (paths are compared after being made canonical).
+			auto loadFilesMatching(evo::ArrayProxy<fs::path> patterns) noexcept -> void;
+
+			// Same as `loadFilesMatching()`, but each file is tokenized as soon as it's loaded
+			auto loadAndTokenizeFilesMatching(evo::ArrayProxy<fs::path> patterns) noexcept -> void;
+
+			// Same as `loadAndTokenizeFilesMatching()`, but for running the same patterns again to find the files
+			// 		created since: only files that exist are loaded, and patterns that match nothing (or can't be
+			// 		searched) aren't reported again
+			auto loadAndTokenizeNewFilesMatching(evo::ArrayProxy<fs::path> patterns) noexcept -> void;
+
+			static constexpr std::string_view SOURCE_FILE_EXTENSION = ".pthr";
+
+			// Applies edits to a source that was already tokenized and re-tokenizes only what the edits could have
+			// 		changed (until the tokens resync with the old ones). The tokens are the same as re-tokenizing the
+			// 		whole edited source (as long as the source had tokenized without errors).
+			// Runs on the calling thread and no tasks can be running on the source. The data of the source cannot
+			// 		have been released.
+			// Returns false if re-tokenizing emitted any errors or the context already hit the fail condition
+			// 		(the source is then left with no tokens, so the next edit re-tokenizes all of it)
+			auto editSource(Source::ID source_id, evo::ArrayProxy<Source::Edit> edits) noexcept -> bool;
+
+			// Re-reads the file a source was loaded from and re-tokenizes only the part of it that changed (through
+			// 		`editSource`). Nothing is re-tokenized if the file has the same data as the source.
+			// The source cannot be memory-mapped (the mapped data changes along with the file).
+			// Returns false if the file couldn't be read or re-tokenizing emitted any errors
+			auto reloadSourceFile(Source::ID source_id) noexcept -> bool;
+
+			// Reloads the files of a number of sources (in parallel when multi-threaded)
+			auto reloadSourceFiles(evo::ArrayProxy<Source::ID> source_ids) noexcept -> void;
+
+			// Forgets all errors so far (including hitting the fail condition) so the context can keep being used,
+			// 		for example by a long-running process that re-tokenizes files as they change.
+			// 		Until this is called after hitting the fail condition, every task submitted is cancelled.
+			// No task group can be running.
+			auto clearErrors() noexcept -> void;
+
+			// Removes every source (and their tokens), every interned string, all errors, and the profile data, so
+			// 		the context can be used again as if it was just created. The threads keep running and the storage
+			// 		of the sources and interned strings is kept to be reused, so it's cheaper than a new context.
+			// Invalidates every reference to sources, tokens, and interned strings. No task group can be running.
+			auto reset() noexcept -> void;
+
+			struct BatchSource{
+				std::string name; // location of the source (for diagnostics)
+				std::string data;
+			};
+
+			struct BatchResult{
+				Source::ID sourceID;
+				bool tokenized; // false if it errored (or was cancelled because the fail condition was hit)
+			};
+
+			// Adds sources from memory and tokenizes just them (not any other sources that aren't tokenized yet).
+			// 		Returns once they're all done and the diagnostics were delivered, with a result for each source
+			// 		(in the same order as `sources`).
+			// Meant for compiling many small batches back to back (calling `reset()` between them).
+			EVO_NODISCARD auto tokenizeBatch(std::vector<BatchSource>&& sources) noexcept -> std::vector<BatchResult>;
+
+			// Everything recorded so far if `Config::collectProfileData` is set (empty otherwise).
+			// No task group can be running.
+			EVO_NODISCARD auto getProfileData() const noexcept -> ProfileData;
+
+			// What the sources and interned strings are using right now (by source and by what it's used for).
+			// No task group can be running.
+			EVO_NODISCARD auto getMemoryUsage() const noexcept -> MemoryUsage;
 			
 
 
@@ -71,6 +213,15 @@ namespace pcit::panther{
 
 			EVO_NODISCARD auto getConfig() const noexcept -> const Config& { return this->config; };
 
+			// thread-safe, strings interned here live as long as the Context
+			// 	(string literals that have escape sequences are saved here)
+			EVO_NODISCARD auto getStringInterner()       noexcept ->       core::StringInterner& {
+				return this->string_interner;
+			};
+			EVO_NODISCARD auto getStringInterner() const noexcept -> const core::StringInterner& {
+				return this->string_interner;
+			};
+
 
 
 			///////////////////////////////////
@@ -131,84 +282,322 @@ namespace pcit::panther{
 		private:
 			auto emit_diagnostic_internal(auto&&... args) noexcept -> void {
 				auto diagnostic = Diagnostic(std::forward<decltype(args)>(args)...);
-				this->emit_diagnostic_impl(diagnostic);
+				this->emit_diagnostic_impl(std::move(diagnostic));
 			};
 
-			auto emit_diagnostic_impl(const Diagnostic& diagnostic) noexcept -> void;
+			auto emit_diagnostic_impl(Diagnostic&& diagnostic) noexcept -> void;
+
+			// delivers all buffered diagnostics (does nothing if `Config::immediateDiagnostics`)
+			auto flush_diagnostics() noexcept -> void;
+
+			// calls the callback (`callback_mutex` must be locked)
+			auto deliver_diagnostic(const Diagnostic& diagnostic) noexcept -> void;
 			auto notify_task_errored() noexcept -> void;
+			auto shutdown_threads_impl() noexcept -> void;
 			auto consume_tasks_single_threaded() noexcept -> void;
+
+			// `editSource()` / `reloadSourceFile()` without delivering the diagnostics (for tasks)
+			// 	(re-tokenizing stops early once a stop is requested of `stop_token`)
+			auto edit_source_impl(
+				Source::ID source_id, evo::ArrayProxy<Source::Edit> edits, const std::stop_token& stop_token
+			) noexcept -> bool;
+			auto reload_source_file_impl(Source::ID source_id, const std::stop_token& stop_token) noexcept -> bool;
+
+			// tokenizes all of a source on the calling thread (replacing any tokens it had)
+			auto retokenize_source(Source::ID source_id, const std::stop_token& stop_token) noexcept -> bool;
+
+			// emits an error (and returns false) if the data of the source isn't valid UTF-8
+			EVO_NODISCARD auto check_source_is_valid_utf8(const Source& source) noexcept -> bool;
+
+			// emits an error (and returns false) if the brackets of the tokens aren't balanced
+			EVO_NODISCARD auto check_brackets_are_balanced(
+				const Source& source, const TokenBuffer& token_buffer
+			) noexcept -> bool;
+
+			// moves the token strings out of the data (so it can be freed) and marks the data to be released
+			auto prepare_source_data_release(Source::ID source_id) noexcept -> void;
+
+			// releases the data of every source marked by `prepare_source_data_release()`
+			auto release_pending_source_data() noexcept -> void;
+
+
+			///////////////////////////////////
+			// profiling
+
+			struct ProfileBuffer{
+				std::vector<ProfileData::Event> events{};
+				ProfileData::Counters counters{};
+			};
+
+			EVO_NODISCARD auto is_collecting_profile_data() const noexcept -> bool {
+				return this->config.collectProfileData;
+			};
+
+			// nanoseconds since the context was created
+			EVO_NODISCARD auto get_profile_time() const noexcept -> uint64_t;
+
+			// index of the worker of the current thread, or `ProfileData::EXTERNAL_THREAD`
+			EVO_NODISCARD auto get_profile_thread() const noexcept -> uint32_t;
+
+			// calls `func` with the buffer of the current thread (only when collecting profile data)
+			auto with_profile_buffer(auto&& func) noexcept -> void;
+
+			// Locks the mutex, and if collecting profile data and the lock was contended, records the time spent
+			// 		waiting for it
+			EVO_NODISCARD auto lock_profiled(std::mutex& mutex, ProfileData::Lock lock) noexcept
+				-> std::unique_lock<std::mutex>;
 	
 		private:
 			Config config;
 
 			SourceManager src_manager;
-			std::mutex src_manager_mutex{};
+
+			core::StringInterner string_interner{};
 
 
 			DiagnosticCallback callback;
 			std::mutex callback_mutex{};
 
+			// One for each worker (or one if single-threaded), each only written by the thread of that worker.
+			// The last one is for anything emitted outside of a worker, and is locked with
+			// 		`external_diagnostic_buffer_mutex` (as is every buffer when they're being flushed).
+			// 	(empty if `Config::immediateDiagnostics`)
+			std::vector<std::vector<Diagnostic>> diagnostic_buffers{};
+			std::mutex external_diagnostic_buffer_mutex{};
+
+
+			// One for each worker (or one if single-threaded), each only written by the thread of that worker.
+			// The last one is for anything done outside of a worker, and is locked with `external_profile_mutex`.
+			// 	(empty if not collecting profile data)
+			std::vector<ProfileBuffer> profile_buffers{};
+			std::mutex external_profile_mutex{};
+			std::chrono::steady_clock::time_point profile_start_time;
+
 
 			///////////////////////////////////
 			// threading
 
 			bool task_group_running = false;
 			std::atomic<evo::uint> num_errors = 0;
-			std::atomic<evo::uint> num_threads_running = 0;
 			std::atomic<bool> hit_fail_condition = false;
+			std::atomic<size_t> num_sources_pending_data_release = 0;
 			std::atomic_flag shutting_down_threads{};
 
+			// Stop is requested when the fail condition is hit, which cancels the rest of the task group: tasks that
+			// 		haven't started are dropped, and running tasks are given the token (`QueuedTask::stopToken`) so
+			// 		tokenizers stop at their next check (every `Tokenizer::CANCELLATION_CHECK_INTERVAL` tokens) and
+			// 		directory walks at their next entry. The workers keep running, so the next task group (after
+			// 		`clearErrors()`) doesn't have to start them up again. Replaced by `clearErrors()`.
+			std::stop_source task_group_stop_source{};
+
+			// The phases a source goes through (in order). Each task runs one phase for one source, and once it's
+			// 		done, it adds the task for the next phase of that same source (until `lastPhase` is reached).
+			// 		This lets each source move through the pipeline on its own without any global barrier.
+			// To add a phase, add it here, create the task type for it, and add it to `add_next_phase_task()`
+			enum class TaskPhase{
+				Load,
+				Tokenize,
+			};
+
 			struct LoadFileTask{
 				fs::path path;
-				int num;
+				TaskPhase lastPhase;
 			};
 
 			struct TokenizeFileTask{
 				Source::ID source_id;
+				TaskPhase lastPhase;
 			};
 
-			using Task = evo::Variant<LoadFileTask, TokenizeFileTask>;
+			// shared by all of the `TokenizeChunkTask`s of a source
+			// 	(the last chunk to finish joins the token buffers and moves the source on to the next phase)
+			struct TokenizeChunksState{
+				Source::ID source_id;
+				TaskPhase lastPhase;
+				std::vector<uint32_t> chunkStarts;
+				std::vector<TokenBuffer> chunkTokenBuffers;
+				std::optional<uint64_t> tokenCacheKey;
+				std::atomic<size_t> numChunksLeft;
+				std::atomic<bool> errored = false;
+			};
+
+			struct TokenizeChunkTask{
+				std::shared_ptr<TokenizeChunksState> state;
+				size_t chunk_index;
+			};
+
+			struct ReloadFileTask{
+				Source::ID source_id;
+			};
+
+			// shared by all of the `FileSearch`es of a call to `loadFilesMatching()` / `loadAndTokenizeFilesMatching()`
+			struct FileDiscoveryState{
+				TaskPhase lastPhase;
+				bool onlyNewFiles; // `loadAndTokenizeNewFilesMatching()`
+				std::mutex mutex{};
+			};
+
+			// one for each pattern (shared by all of the `DiscoverFilesTask`s searching for it)
+			struct FileSearch{
+				std::shared_ptr<FileDiscoveryState> discovery;
+				fs::path pattern;
+				fs::path base;
+				std::vector<std::string> patternComponents;
+
+				// canonical paths (so symlinks can't make a directory get searched more than once)
+				// 	(guarded by the mutex of `discovery`)
+				std::unordered_set<std::string> searchedDirectories{};
+
+				std::atomic<size_t> numDirectoriesLeft = 1;
+				std::atomic<bool> foundAnyFiles = false;
+				std::atomic<bool> failed = false;
+			};
+
+			// searches one directory (adds tasks for the subdirectories that could have matches and loads the files)
+			struct DiscoverFilesTask{
+				std::shared_ptr<FileSearch> search;
+				std::vector<std::string> directoryComponents; // relative to `FileSearch::base`
+			};
+
+			using Task = evo::Variant<
+				LoadFileTask, TokenizeFileTask, TokenizeChunkTask, ReloadFileTask, DiscoverFilesTask
+			>;
+
+			struct QueuedTask{
+				Task task;
+				std::stop_token stopToken; // of the task group the task is part of
+				uint64_t queuedTime; // only set when collecting profile data
+			};
+
+			// if called from a worker thread, the task is added to the deque of that worker
+			auto add_task(Task&& task) noexcept -> void;
+
+			auto add_next_phase_task(Source::ID source_id, TaskPhase completed_phase, TaskPhase last_phase) noexcept
+				-> void;
+			auto add_load_file_tasks(evo::ArrayProxy<fs::path> file_paths, TaskPhase last_phase) noexcept -> void;
+			auto add_discover_files_tasks(
+				evo::ArrayProxy<fs::path> patterns, TaskPhase last_phase, bool only_new_files
+			) noexcept -> void;
 
-			std::queue<std::unique_ptr<Task>> tasks{};
-			std::mutex tasks_mutex{};
+			// adds the task to load the file if it's the first time any discovery found it
+			auto add_discovered_file(FileDiscoveryState& discovery, fs::path&& path) noexcept -> void;
+
+			// canonical paths of every file found by a discovery (so each file is only loaded once)
+			// 	(a file that failed to load is removed so it's loaded again if it's found again)
+			std::unordered_set<std::string> discovered_files{};
+			std::mutex discovered_files_mutex{};
+
+			// only used when single-threaded (multi-threaded tasks live in the `TaskDeque` of each `Worker`)
+			std::queue<QueuedTask> single_threaded_tasks{};
+
+			// number of tasks submitted that have not finished running yet
+			// 	(waited / notified on when it hits 0 so `waitForAllTasks()` returns as soon as the last task is done)
+			std::atomic<size_t> num_unfinished_tasks = 0;
+
+			// number of tasks sitting in a `TaskDeque` that no worker has taken yet
+			std::atomic<size_t> num_queued_tasks = 0;
+
+			// idle workers park on `work_available_cv` instead of polling
+			std::atomic<size_t> num_idle_workers = 0;
+			std::mutex idle_mutex{};
+			std::condition_variable_any work_available_cv{};
+
+			// used to pick which worker gets tasks that are submitted from outside of a worker thread
+			std::atomic<size_t> next_worker_to_submit_to = 0;
+
+
+			// The owning worker pushes and pops from the back (most recently added task first),
+			// 		other workers steal from the front when they run out of their own tasks.
+			// Each deque has its own lock so submitting tasks never has to go through one global lock.
+			class TaskDeque{
+				public:
+					TaskDeque(Context* _context) noexcept : context(_context) {};
+					~TaskDeque() = default;
+
+					TaskDeque(const TaskDeque&) = delete;
+					TaskDeque(TaskDeque&& rhs) noexcept : context(rhs.context), tasks(std::move(rhs.tasks)) {};
+
+					auto push(QueuedTask&& task) noexcept -> void;
+					EVO_NODISCARD auto pop() noexcept -> std::optional<QueuedTask>;
+					EVO_NODISCARD auto steal() noexcept -> std::optional<QueuedTask>;
+
+				private:
+					Context* context;
+					std::deque<QueuedTask> tasks{};
+					std::mutex mutex{};
+			};
 
 
 			class Worker{
 				public:
-					Worker() noexcept : context(nullptr) {};
+					Worker() noexcept : context(nullptr), index(0), task_deque(nullptr) {};
 
-					Worker(Context* _context) noexcept : context(_context) {};
+					Worker(Context* _context, size_t _index) noexcept
+						: context(_context), index(_index), task_deque(_context) {};
 					~Worker() = default;
 
 					Worker(const Worker&) = delete;
 					Worker(Worker&& rhs) noexcept 
 						: context(std::exchange(rhs.context, nullptr)),
-						  is_working(rhs.is_working),
+						  index(rhs.index),
+						  task_deque(std::move(rhs.task_deque)),
 						  thread(std::move(rhs.thread)) {};
 
 
-					auto done() noexcept -> void;
-					auto get_task() noexcept -> void;
+					auto get_task(const std::stop_token& stop_token) noexcept -> void;
 					auto get_task_single_threaded() noexcept -> void;
 
-					EVO_NODISCARD auto isWorking() const noexcept -> bool { return this->is_working; };
+					EVO_NODISCARD auto getContext() const noexcept -> const Context* { return this->context; };
+					EVO_NODISCARD auto getIndex() const noexcept -> size_t { return this->index; };
+					EVO_NODISCARD auto getTaskDeque() noexcept -> TaskDeque& { return this->task_deque; };
 
 					EVO_NODISCARD auto getThread()       noexcept ->       std::jthread& { return this->thread; };
 					EVO_NODISCARD auto getThread() const noexcept -> const std::jthread& { return this->thread; };
 
 				private:
-					auto run_task(const Task& task) noexcept -> void;
+					EVO_NODISCARD auto steal_task() noexcept -> std::optional<QueuedTask>;
+					auto wait_for_task(const std::stop_token& stop_token) noexcept -> void;
+
+					auto run_task(const QueuedTask& queued_task) noexcept -> void;
+					auto record_task_profile(const QueuedTask& queued_task, uint64_t start_time) noexcept -> void;
 					auto run_load_file(const LoadFileTask& task) noexcept -> bool;
-					auto run_tokenize_file(const TokenizeFileTask& task) noexcept -> bool;
+					EVO_NODISCARD auto read_file(const LoadFileTask& task) noexcept -> std::optional<Source::ID>;
+					EVO_NODISCARD auto map_file(const LoadFileTask& task) noexcept -> std::optional<Source::ID>;
+					// the long-running tasks stop early once a stop is requested of the stop token of their task
+					// 		group (`QueuedTask::stopToken`)
+					auto run_tokenize_file(const TokenizeFileTask& task, const std::stop_token& stop_token)
+						noexcept -> bool;
+					auto add_tokenize_chunk_tasks(
+						const TokenizeFileTask& task, std::optional<uint64_t> token_cache_key
+					) noexcept -> void;
+					auto run_tokenize_chunk(const TokenizeChunkTask& task, const std::stop_token& stop_token)
+						noexcept -> bool;
+					auto run_discover_files(const DiscoverFilesTask& task, const std::stop_token& stop_token)
+						noexcept -> bool;
+					// only called for sources that tokenized without errors (cached tokens are used without
+					// 		re-reporting any errors)
+					auto save_to_token_cache(const Source& source, std::optional<uint64_t> token_cache_key) noexcept
+						-> void;
+					auto add_tokens_produced(size_t num_tokens) noexcept -> void;
 
 				private:
 					Context* context;
-					bool is_working = false;
+					size_t index;
+					TaskDeque task_deque;
+
+					// set by `run_load_file` so the profile event of the task knows which source was loaded
+					uint32_t loaded_source_id = ProfileData::NO_SOURCE;
 					std::jthread thread{};
 			};
 
 
 			std::vector<Worker> workers{};
+
+			// the worker (if any) that is running on the current thread
+			static thread_local Worker* current_worker;
+
+			// the worker of the current thread, or nullptr if it isn't one of the workers of this context
+			EVO_NODISCARD auto get_current_worker() const noexcept -> const Worker*;
 	};
 
 
@@ -17,7 +17,9 @@
 #include "./Source.h"
 #include "./SourceManager.h"
 #include "./Context.h"
+#include "./ProfileData.h"
 #include "./Token.h"
 #include "./TokenBuffer.h"
+#include "./TokenStream.h"
 
 #include "./default_diagnostic_callback.h"
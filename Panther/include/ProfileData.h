@@ -0,0 +1,124 @@
+//////////////////////////////////////////////////////////////////////
+//                                                                  //
+// Part of the PCIT-CPP, under the Apache License v2.0              //
+// You may not use this file except in compliance with the License. //
+// See `http://www.apache.org/licenses/LICENSE-2.0` for info        //
+//                                                                  //
+//////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+
+#include <array>
+
+#include <Evo.h>
+#include <PCIT_core.h>
+
+
+namespace pcit::panther{
+
+
+	// Timings and counters collected by a Context (when `Context::Config::collectProfileData` is set).
+	// All times are in nanoseconds (timestamps are since the Context was created).
+	struct ProfileData{
+		enum class EventKind : uint8_t {
+			LoadFile,
+			TokenizeFile,
+			TokenizeChunk,
+			ReloadFile,
+			DiscoverFiles,
+			DiagnosticCallback,
+			LockWait, // only recorded when the lock was contended
+		};
+
+		enum class Lock : uint8_t {
+			TaskDeque,
+			Callback,
+			FileDiscovery,
+		};
+		static constexpr size_t NUM_LOCKS = 3;
+
+		// thread index of anything that happened outside of a worker (such as submitting tasks)
+		static constexpr uint32_t EXTERNAL_THREAD = std::numeric_limits<uint32_t>::max();
+		static constexpr uint32_t NO_SOURCE = std::numeric_limits<uint32_t>::max();
+
+		struct Event{
+			EventKind kind;
+			Lock lock; // only for `LockWait`
+			uint32_t thread; // index of the worker (0 when single-threaded), or `EXTERNAL_THREAD`
+			uint32_t sourceID; // `NO_SOURCE` if not related to a source (or a file that failed to load)
+			uint32_t chunkIndex; // only for `TokenizeChunk`
+			uint64_t start;
+			uint64_t end;
+		};
+
+		struct LockCounters{
+			uint64_t numContended = 0;
+			uint64_t waitTime = 0;
+		};
+
+		struct Counters{
+			uint64_t numTasks = 0;
+			uint64_t taskTime = 0;
+			uint64_t queueWaitTime = 0; // time tasks spent queued before a worker started running them
+			uint64_t idleTime = 0; // time workers spent waiting for tasks
+			uint64_t bytesLoaded = 0;
+			uint64_t tokensProduced = 0;
+			uint64_t numDiagnostics = 0;
+			uint64_t diagnosticCallbackTime = 0;
+			std::array<LockCounters, NUM_LOCKS> locks{};
+
+			auto operator+=(const Counters& rhs) noexcept -> Counters& {
+				this->numTasks               += rhs.numTasks;
+				this->taskTime               += rhs.taskTime;
+				this->queueWaitTime          += rhs.queueWaitTime;
+				this->idleTime               += rhs.idleTime;
+				this->bytesLoaded            += rhs.bytesLoaded;
+				this->tokensProduced         += rhs.tokensProduced;
+				this->numDiagnostics         += rhs.numDiagnostics;
+				this->diagnosticCallbackTime += rhs.diagnosticCallbackTime;
+
+				for(size_t i = 0; i < NUM_LOCKS; i+=1){
+					this->locks[i].numContended += rhs.locks[i].numContended;
+					this->locks[i].waitTime     += rhs.locks[i].waitTime;
+				}
+
+				return *this;
+			};
+		};
+
+
+		std::vector<Event> events; // sorted by start time
+		std::vector<Counters> threadCounters; // index is the thread (anything external comes last)
+		Counters totalCounters;
+		uint64_t endTime; // when this was collected
+
+
+		EVO_NODISCARD static constexpr auto printEventKind(EventKind kind) noexcept -> std::string_view {
+			switch(kind){
+				case EventKind::LoadFile:           return "LoadFile";
+				case EventKind::TokenizeFile:       return "TokenizeFile";
+				case EventKind::TokenizeChunk:      return "TokenizeChunk";
+				case EventKind::ReloadFile:         return "ReloadFile";
+				case EventKind::DiscoverFiles:      return "DiscoverFiles";
+				case EventKind::DiagnosticCallback: return "DiagnosticCallback";
+				case EventKind::LockWait:           return "LockWait";
+			};
+
+			evo::debugFatalBreak("Unknown or unsupported event kind");
+		};
+
+		EVO_NODISCARD static constexpr auto printLock(Lock lock) noexcept -> std::string_view {
+			switch(lock){
+				case Lock::TaskDeque:     return "TaskDeque";
+				case Lock::Callback:      return "Callback";
+				case Lock::FileDiscovery: return "FileDiscovery";
+			};
+
+			evo::debugFatalBreak("Unknown or unsupported lock");
+		};
+	};
+
+
+};
@@ -28,14 +28,49 @@ namespace pcit::panther{
 			using Location = SourceLocation;
 
 		public:
-			Source(Source&& rhs) noexcept : id(rhs.id), location(std::move(rhs.location)), data(std::move(rhs.data)) {};
+			Source(Source&& rhs) noexcept 
+				: id(rhs.id),
+				  location(std::move(rhs.location)),
+				  data(std::move(rhs.data)),
+				  data_start(rhs.data_start),
+				  is_ascii(rhs.is_ascii),
+				  invalid_utf8_offset(rhs.invalid_utf8_offset),
+				  line_starts(std::move(rhs.line_starts)),
+				  token_buffer(std::move(rhs.token_buffer)),
+				  is_tokenized(rhs.is_tokenized),
+				  is_data_released(rhs.is_data_released),
+				  is_data_release_pending(rhs.is_data_release_pending),
+				  released_data_size(rhs.released_data_size)
+				{};
 			Source(const Source&) = delete;
 
 			~Source() = default;
 
 			
 			EVO_NODISCARD auto getID() const noexcept -> ID { return this->id; };
-			EVO_NODISCARD auto getData() const noexcept -> const std::string& { return this->data; };
+
+			// Views into the data are valid for the lifetime of the Source (whether it's owned or memory-mapped),
+			// 		unless the data is released (see `Context::Config::releaseSourceData`), which makes it empty.
+			// A UTF-8 byte order mark at the start of the file is not part of the data (it's skipped, not copied),
+			// 		so offsets are from just after it.
+			EVO_NODISCARD auto getData() const noexcept -> std::string_view;
+			EVO_NODISCARD auto isMemoryMapped() const noexcept -> bool;
+			EVO_NODISCARD auto isDataReleased() const noexcept -> bool { return this->is_data_released; };
+			// if the byte order mark was skipped (edited data never has one, as it's built from `getData()`)
+			EVO_NODISCARD auto hasByteOrderMark() const noexcept -> bool { return this->data_start != 0; };
+
+			static constexpr std::string_view UTF8_BYTE_ORDER_MARK = "\xEF\xBB\xBF";
+
+			// The data is validated as UTF-8 when the Source is created (and after every edit).
+			// `getInvalidUTF8Offset()` is the offset of the first invalid sequence (the Context reports it as an error
+			// 		and doesn't tokenize the source). A source that's all ASCII is also valid UTF-8.
+			EVO_NODISCARD auto isASCII() const noexcept -> bool { return this->is_ascii; };
+			EVO_NODISCARD auto isValidUTF8() const noexcept -> bool {
+				return this->invalid_utf8_offset.has_value() == false;
+			};
+			EVO_NODISCARD auto getInvalidUTF8Offset() const noexcept -> std::optional<uint32_t> {
+				return this->invalid_utf8_offset;
+			};
 
 			EVO_NODISCARD auto locationIsPath() const noexcept -> bool;
 			EVO_NODISCARD auto locationIsString() const noexcept -> bool;
@@ -45,40 +80,155 @@ namespace pcit::panther{
 			EVO_NODISCARD auto getLocationAsString() const noexcept -> std::string;
 
 			EVO_NODISCARD auto getTokenBuffer() const noexcept -> const TokenBuffer& { return this->token_buffer; };
+
+			// If the last time the Context tokenized the source (or re-tokenized it after an edit) it succeeded
+			EVO_NODISCARD auto isTokenized() const noexcept -> bool { return this->is_tokenized; };
+
+
+			struct LineAndCollumn{
+				uint32_t line;
+				uint32_t collumn;
+			};
+
+			// Lines and collumns start at 1.
+			// "\n", "\r\n", and "\r" are each a single line break.
+			EVO_NODISCARD auto getLineAndCollumn(uint32_t offset) const noexcept -> LineAndCollumn;
+			EVO_NODISCARD auto getLineStartOffset(uint32_t line) const noexcept -> uint32_t;
+			EVO_NODISCARD auto numLines() const noexcept -> size_t { return this->line_starts.size(); };
+
+			// `end_offset` is 1 past the last character (matching the end of a Token::Location)
+			EVO_NODISCARD auto getLocation(uint32_t start_offset, uint32_t end_offset) const noexcept -> Location;
+			EVO_NODISCARD auto getLocation(uint32_t offset) const noexcept -> Location;
+
+
+			// in bytes (including spare capacity)
+			struct MemoryUsage{
+				size_t ownedData = 0;
+				size_t mappedData = 0; // in the OS page cache (shared with anything else that maps the file)
+				size_t lineStarts = 0;
+				TokenBuffer::MemoryUsage tokens{};
+
+				// everything but `mappedData`
+				EVO_NODISCARD auto totalAllocated() const noexcept -> size_t {
+					return this->ownedData + this->lineStarts + this->tokens.total();
+				};
+
+				auto operator+=(const MemoryUsage& rhs) noexcept -> MemoryUsage& {
+					this->ownedData  += rhs.ownedData;
+					this->mappedData += rhs.mappedData;
+					this->lineStarts += rhs.lineStarts;
+					this->tokens     += rhs.tokens;
+					return *this;
+				};
+			};
+
+			EVO_NODISCARD auto getMemoryUsage() const noexcept -> MemoryUsage;
+
+
+			// Offsets of edits are into the data from before any of the edits were applied, and edits cannot overlap
+			// 	(applied with `Context::editSource()`)
+			struct Edit{
+				uint32_t offset;
+				uint32_t removedLength;
+				std::string_view insertedText;
+			};
 			
 
+		private:
+			// skips the byte order mark (if there is one), validates the data, and builds the line starts
+			auto init_data() noexcept -> void;
+			auto validate_utf8() noexcept -> void;
+			auto build_line_starts() noexcept -> void;
+
+			// the range of the data that was changed by a set of edits
+			struct EditedRange{
+				uint32_t start;
+				uint32_t oldEnd;
+				uint32_t newEnd;
+				uint32_t firstMovedToken; // first token that started at or after `oldEnd` (moved to the edited data)
+			};
+
+			// Replaces the data with the edited data (which is always owned, even if the source was memory-mapped) and
+			// 		updates the line starts and the tokens after the edited range. The tokens that were in the edited
+			// 		range are left as is for the Context to re-tokenize.
+			auto apply_edits(evo::ArrayProxy<Edit> edits) noexcept -> EditedRange;
+
+			// Frees (or unmaps) the data. The tokens must not have any views into it anymore, and only what's kept
+			// 		(the tokens and line starts) can be used afterwards.
+			auto release_data() noexcept -> void;
+
+			// for reloading a source that had its data released (the tokens are cleared to be re-tokenized)
+			auto replace_released_data(std::string&& new_data) noexcept -> void;
+
 		private:
 			Source(ID src_id, const std::string& loc, const std::string& data_str) noexcept
-				: id(src_id), location(loc), data(data_str) {};
+				: id(src_id), location(loc), data(data_str) {
+				this->init_data();
+			};
 
 			Source(ID src_id, const std::string& loc, std::string&& data_str) noexcept
-				: id(src_id), location(loc), data(std::move(data_str)) {};
+				: id(src_id), location(loc), data(std::move(data_str)) {
+				this->init_data();
+			};
 
 			Source(ID src_id, std::string&& loc, const std::string& data_str) noexcept
-				: id(src_id), location(std::move(loc)), data(data_str) {};
+				: id(src_id), location(std::move(loc)), data(data_str) {
+				this->init_data();
+			};
 
 			Source(ID src_id, std::string&& loc, std::string&& data_str) noexcept
-				: id(src_id), location(std::move(loc)), data(std::move(data_str)) {};
+				: id(src_id), location(std::move(loc)), data(std::move(data_str)) {
+				this->init_data();
+			};
 
 
 			Source(ID src_id, const fs::path& loc, const std::string& data_str) noexcept
-				: id(src_id), location(loc), data(data_str) {};
+				: id(src_id), location(loc), data(data_str) {
+				this->init_data();
+			};
 
 			Source(ID src_id, const fs::path& loc, std::string&& data_str) noexcept
-				: id(src_id), location(loc), data(std::move(data_str)) {};
+				: id(src_id), location(loc), data(std::move(data_str)) {
+				this->init_data();
+			};
 
 			Source(ID src_id, fs::path&& loc, const std::string& data_str) noexcept
-				: id(src_id), location(std::move(loc)), data(data_str) {};
+				: id(src_id), location(std::move(loc)), data(data_str) {
+				this->init_data();
+			};
 
 			Source(ID src_id, fs::path&& loc, std::string&& data_str) noexcept
-				: id(src_id), location(std::move(loc)), data(std::move(data_str)) {};
+				: id(src_id), location(std::move(loc)), data(std::move(data_str)) {
+				this->init_data();
+			};
+
+
+			Source(ID src_id, const fs::path& loc, core::MappedFile&& mapped_file) noexcept
+				: id(src_id), location(loc), data(std::move(mapped_file)) {
+				this->init_data();
+			};
+
+			Source(ID src_id, fs::path&& loc, core::MappedFile&& mapped_file) noexcept
+				: id(src_id), location(std::move(loc)), data(std::move(mapped_file)) {
+				this->init_data();
+			};
 	
 		private:
 			ID id;
 			evo::Variant<fs::path, std::string> location;
-			std::string data;
+			evo::Variant<std::string, core::MappedFile> data;
+			uint32_t data_start = 0; // size of the byte order mark that was skipped (if there was one)
+			bool is_ascii = true;
+			std::optional<uint32_t> invalid_utf8_offset{};
+
+			std::vector<uint32_t> line_starts{}; // offset of the first character of each line
 
 			TokenBuffer token_buffer{};
+			bool is_tokenized = false; // set by the Context
+
+			bool is_data_released = false;
+			bool is_data_release_pending = false; // released once the task group is done (set by the Context)
+			size_t released_data_size = 0; // so offsets can still be checked against it
 
 			friend class SourceManager;
 			friend class Context;
@@ -9,6 +9,8 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <filesystem>
 namespace fs = std::filesystem;
 
@@ -20,13 +22,29 @@ namespace fs = std::filesystem;
 namespace pcit::panther{
 
 
+	// Sources are stored in segments that are each twice the size of the last, so a Source never moves once it's
+	// 		added (references to it, and views into its data and tokens, stay valid for the whole lifetime of the
+	// 		SourceManager).
+	// Adding sources is thread-safe and lock-free: the ID is taken from an atomic counter and a segment is only
+	// 		allocated by whichever thread first needs it (the others use the one it published).
+	// `getSource()` of an ID is safe from any thread once `addSource()` returned it. Iterating (and `numSources()`)
+	// 		is only meaningful when no sources are being added.
 	class SourceManager{
 		public:
 			SourceManager() = default;
-			~SourceManager() = default;
+			~SourceManager() noexcept;
 
-			// make sure enough space for `num_source` source is allocated
-			auto reserveSources(size_t num_source) noexcept -> void;
+			SourceManager(const SourceManager&) = delete;
+			SourceManager(SourceManager&&) = delete;
+
+			// Removes (destroys) every source, but keeps the segments they were stored in to be reused.
+			// Invalidates every reference to the sources (and every view into their data and tokens), and the IDs
+			// 		start from 0 again. No sources can be being added or used.
+			auto clear() noexcept -> void;
+
+			// allocates the segments needed for `num_sources` sources ahead of time (never needed, but saves
+			// 		whichever thread adds the first source of a segment from allocating it)
+			auto reserveSources(size_t num_sources) noexcept -> void;
 
 			auto addSource(const std::string& location, const std::string& data) noexcept -> Source::ID;
 			auto addSource(const std::string& location, std::string&& data) noexcept -> Source::ID;
@@ -38,26 +56,60 @@ namespace pcit::panther{
 			auto addSource(fs::path&& location, const std::string& data) noexcept -> Source::ID;
 			auto addSource(fs::path&& location, std::string&& data) noexcept -> Source::ID;
 
+			// the source views directly into the mapped file (no copy)
+			auto addSource(const fs::path& location, core::MappedFile&& mapped_file) noexcept -> Source::ID;
+			auto addSource(fs::path&& location, core::MappedFile&& mapped_file) noexcept -> Source::ID;
+
 
 			EVO_NODISCARD auto getSource(Source::ID id)       noexcept ->       Source&;
 			EVO_NODISCARD auto getSource(Source::ID id) const noexcept -> const Source&;
 
-			EVO_NODISCARD auto numSources() const noexcept -> size_t { return this->sources.size(); };
+			EVO_NODISCARD auto numSources() const noexcept -> size_t { return this->num_sources.load(); };
 
 			EVO_NODISCARD auto begin() const noexcept -> Source::ID::Iterator {
 				return Source::ID::Iterator(Source::ID(0));
 			};
 
 			EVO_NODISCARD auto end() const noexcept -> Source::ID::Iterator {
-				return Source::ID::Iterator(Source::ID(uint32_t(this->sources.size())));
+				return Source::ID::Iterator(Source::ID(uint32_t(this->numSources())));
+			};
+
+
+			// in bytes
+			struct MemoryUsage{
+				std::vector<Source::MemoryUsage> sources{}; // index is the ID of the source
+				Source::MemoryUsage total{};
+				size_t storage = 0; // the segments the sources are stored in
 			};
 
+			// only meaningful when no sources are being added or changed (same as iterating)
+			EVO_NODISCARD auto getMemoryUsage() const noexcept -> MemoryUsage;
+
 	
 		private:
-			std::vector<Source> sources{};
+			EVO_NODISCARD auto add_source(auto&&... source_args) noexcept -> Source::ID;
 
-			friend class Context;
-	};
+			struct SlotIndex{
+				size_t segment;
+				size_t index; // in the segment
+			};
+			EVO_NODISCARD static auto get_slot_index(uint32_t source_index) noexcept -> SlotIndex;
+			EVO_NODISCARD static auto get_segment_size(size_t segment) noexcept -> size_t {
+				return FIRST_SEGMENT_SIZE << segment;
+			};
 
+			// returns the segment (allocating it if no other thread has yet)
+			EVO_NODISCARD auto get_or_create_segment(size_t segment) noexcept -> Source*;
+
+		private:
+			static constexpr size_t FIRST_SEGMENT_SIZE = 64;
+
+			// enough for every ID a `uint32_t` can hold
+			static constexpr size_t MAX_NUM_SEGMENTS = 27;
+
+			// each is uninitialized memory for `get_segment_size()` sources (or nullptr if not allocated yet)
+			std::array<std::atomic<Source*>, MAX_NUM_SEGMENTS> segments{};
+			std::atomic<uint32_t> num_sources = 0;
+	};
 
 };
\ No newline at end of file
@@ -19,6 +19,8 @@
 namespace pcit::panther{
 
 
+	class Source;
+
 	class Token{
 		public:
 			struct ID : public core::UniqueComparableID<uint32_t, ID> { // ID lookup in TokenBuffer
@@ -27,7 +29,7 @@ namespace pcit::panther{
 					using Iterator = IteratorImpl<ID>;
 			};
 
-			enum class Kind{
+			enum class Kind : uint8_t {
 				None,
 
 				Ident,
@@ -66,11 +68,17 @@ namespace pcit::panther{
 			};
 			using enum class Kind;
 
+			// Line and collumn are resolved through the Source (see `getSourceLocation()`)
 			struct Location{
-				uint32_t lineStart;
-				uint32_t lineEnd;
-				uint32_t collumnStart;
-				uint32_t collumnEnd;
+				uint32_t offset; // byte offset into the source data
+				uint32_t length;
+			};
+
+			union Value{
+				bool boolean;
+				uint64_t integer;
+				float64_t floating_point;
+				std::string_view string;
 			};
 
 		public:
@@ -88,6 +96,9 @@ namespace pcit::panther{
 			Token(Kind _kind, Location _location, std::string_view val) noexcept
 				: kind(_kind), location(_location), value{.string = val} {};
 
+			Token(Kind _kind, Location _location, const Value& val) noexcept
+				: kind(_kind), location(_location), value(val) {};
+
 			~Token() = default;
 
 
@@ -95,15 +106,7 @@ namespace pcit::panther{
 
 			EVO_NODISCARD auto getLocation() const noexcept -> const Location& { return this->location; };
 
-			EVO_NODISCARD auto getSourceLocation(SourceID source_id) const noexcept -> SourceLocation {
-				return SourceLocation(
-					source_id,
-					this->location.lineStart,
-					this->location.lineEnd,
-					this->location.collumnStart,
-					this->location.collumnEnd
-				);
-			};
+			EVO_NODISCARD auto getSourceLocation(const Source& source) const noexcept -> SourceLocation;
 
 
 			EVO_NODISCARD auto getBool() const noexcept -> bool {
@@ -121,6 +124,8 @@ namespace pcit::panther{
 				return this->value.floating_point;
 			};
 
+			// A view into either the data of the source or the string interner (which one depends on the token and on
+			// 		`Context::Config`), so equal strings don't always have the same view (compare them by content)
 			EVO_NODISCARD auto getString() const noexcept -> std::string_view {
 				evo::debugAssert(
 					this->kind == Kind::LiteralString || this->kind == Kind::LiteralChar ||
@@ -133,68 +138,115 @@ namespace pcit::panther{
 
 
 
-			EVO_NODISCARD static constexpr auto lookupKind(std::string_view op_str) noexcept -> Kind {
-				// length 2
-				if(op_str == "->"){ return Kind::RightArrow; }
+			// How each kind of token is spelled. `printKind()` and `lookupKind()` are generated from this, and so are
+			// 		the Tokenizer's keyword table and operator trie (so a new token only needs to be added here).
+			enum class SpellingCategory : uint8_t {
+				Name,     // not tokenized from this spelling (just what `printKind()` returns)
+				Keyword,  // identifiers with this spelling are this kind instead
+				Operator, // operators and punctuation (tokenized with maximal munch)
+			};
 
-				// length 1
-				if(op_str == "="){ return Kind::Equal; }
+			struct KindSpec{
+				Kind kind;
+				std::string_view spelling;
+				SpellingCategory category;
+			};
 
-				evo::debugFatalBreak("Uknown or unsupported kind ({})", op_str);
+			// The first spec of each kind is what `printKind()` returns
+			static constexpr auto KIND_SPECS = std::to_array<KindSpec>({
+				{Kind::None,          "None",          SpellingCategory::Name},
+				{Kind::Ident,         "Ident",         SpellingCategory::Name},
+				{Kind::Intrinsic,     "Intrinsic",     SpellingCategory::Name},
+				{Kind::Attribute,     "Attribute",     SpellingCategory::Name},
+
+				// literals
+				{Kind::LiteralInt,    "LiteralInt",    SpellingCategory::Name},
+				{Kind::LiteralFloat,  "LiteralFloat",  SpellingCategory::Name},
+				{Kind::LiteralBool,   "LiteralBool",   SpellingCategory::Name},
+				{Kind::LiteralString, "LiteralString", SpellingCategory::Name},
+				{Kind::LiteralChar,   "LiteralChar",   SpellingCategory::Name},
+				{Kind::LiteralBool,   "true",          SpellingCategory::Keyword},
+				{Kind::LiteralBool,   "false",         SpellingCategory::Keyword},
+
+				// types
+				{Kind::TypeVoid,      "Void",          SpellingCategory::Keyword},
+				{Kind::TypeType,      "Type",          SpellingCategory::Keyword},
+
+				// keywords
+				{Kind::KeywordFunc,   "func",          SpellingCategory::Keyword},
+
+				// operators
+				{Kind::RightArrow,    "->",            SpellingCategory::Operator},
+				{Kind::Equal,         "=",             SpellingCategory::Operator},
+
+				// punctuation
+				{Kind::OpenParen,     "(",             SpellingCategory::Operator},
+				{Kind::CloseParen,    ")",             SpellingCategory::Operator},
+				{Kind::OpenBracket,   "[",             SpellingCategory::Operator},
+				{Kind::CloseBracket,  "]",             SpellingCategory::Operator},
+				{Kind::OpenBrace,     "{",             SpellingCategory::Operator},
+				{Kind::CloseBrace,    "}",             SpellingCategory::Operator},
+				{Kind::Comma,         ",",             SpellingCategory::Operator},
+				{Kind::SemiColon,     ";",             SpellingCategory::Operator},
+				{Kind::Colon,         ":",             SpellingCategory::Operator},
+				{Kind::Pipe,          "|",             SpellingCategory::Operator},
+			});
+
+			static constexpr size_t MAX_OPERATOR_LENGTH = [](){
+				size_t max_length = 0;
+				for(const KindSpec& spec : KIND_SPECS){
+					if(spec.category == SpellingCategory::Operator){
+						max_length = std::max(max_length, spec.spelling.size());
+					}
+				}
+				return max_length;
+			}();
+
+
+			// the kind of a keyword or operator, or Kind::None if `str` isn't the spelling of one
+			EVO_NODISCARD static constexpr auto lookupKind(std::string_view str) noexcept -> Kind {
+				for(const KindSpec& spec : KIND_SPECS){
+					if(spec.category != SpellingCategory::Name && spec.spelling == str){ return spec.kind; }
+				}
+
+				return Kind::None;
+			};
+
+			// if `kind` is one of the kinds in `KIND_SPECS` (anything else can only come from corrupted data)
+			EVO_NODISCARD static constexpr auto isValidKind(Kind kind) noexcept -> bool {
+				return KIND_NAMES[size_t(kind)].empty() == false;
+			};
+
+			// if tokens of `kind` always have a value (tokens of any other kind never do)
+			EVO_NODISCARD static constexpr auto kindHasValue(Kind kind) noexcept -> bool {
+				return kind == Kind::Ident || kind == Kind::Intrinsic || kind == Kind::Attribute
+					|| kind == Kind::LiteralInt || kind == Kind::LiteralFloat || kind == Kind::LiteralBool
+					|| kind == Kind::LiteralString || kind == Kind::LiteralChar;
 			};
 
 
 			EVO_NODISCARD static auto printKind(Kind kind) noexcept -> std::string_view {
-				switch(kind){
-					break; case Kind::None:          return "None";
-					break; case Kind::Ident:         return "Ident";
-					break; case Kind::Intrinsic:     return "Intrinsic";
-					break; case Kind::Attribute:     return "Attribute";
-
-					// literals
-					break; case Kind::LiteralInt:    return "LiteralInt";
-					break; case Kind::LiteralFloat:  return "LiteralFloat";
-					break; case Kind::LiteralBool:   return "LiteralBool";
-					break; case Kind::LiteralString: return "LiteralString";
-					break; case Kind::LiteralChar:   return "LiteralChar";
-
-					// types
-					break; case Kind::TypeVoid:      return "Void";
-
-					// keywords
-					break; case Kind::KeywordFunc:   return "func";
-
-					// operators
-					break; case Kind::RightArrow:    return "->";
-					break; case Kind::Equal:         return "=";
-
-					// punctuation
-					break; case Kind::OpenParen:     return "(";
-					break; case Kind::CloseParen:    return ")";
-					break; case Kind::OpenBracket:   return "[";
-					break; case Kind::CloseBracket:  return "]";
-					break; case Kind::OpenBrace:     return "{";
-					break; case Kind::CloseBrace:    return "}";
-					break; case Kind::Comma:         return ",";
-					break; case Kind::SemiColon:     return ";";
-					break; case Kind::Colon:         return ":";
-					break; case Kind::Pipe:          return "|";
-				};
-
-				evo::debugFatalBreak("Unknown or unsupported token kind");
+				const std::string_view name = KIND_NAMES[size_t(kind)];
+				evo::debugAssert(name.empty() == false, "Unknown or unsupported token kind");
+				return name;
 			};
 
 
+		private:
+			static constexpr auto KIND_NAMES = [](){
+				auto names = std::array<std::string_view, 256>();
+
+				for(const KindSpec& spec : KIND_SPECS){
+					if(names[size_t(spec.kind)].empty()){ names[size_t(spec.kind)] = spec.spelling; }
+				}
+
+				return names;
+			}();
+
 		private:
 			Kind kind;
 			Location location;
-
-			union {
-				bool boolean;
-				uint64_t integer;
-				float64_t floating_point;
-				std::string_view string;
-			} value;
+			Value value;
 			
 	};
 
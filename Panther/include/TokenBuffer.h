@@ -19,6 +19,14 @@
 namespace pcit::panther{
 
 
+	// Tokens are stored as a structure-of-arrays (dense kinds, locations, and a side table of values that only has
+	// 		entries for tokens that have one) so passes that only look at kinds touch as little memory as possible.
+	// The value of a token is found with a rank index: for every block of 64 tokens there's a bit-mask of which
+	// 		tokens have a value and the number of values before that block.
+	// Literals can also be created with just their raw text (see `Context::Config::lazyLiteralValues`), which is
+	// 		decoded (and replaced with the value) the first time the token is gotten. That is thread-safe.
+	// Brackets are matched as tokens are added, with the same kind of rank index for the open brackets, so the close
+	// 		bracket of any open bracket is found in constant time (see `getMatchingBracket()`).
 	class TokenBuffer{
 		public:
 			TokenBuffer() = default;
@@ -27,43 +35,190 @@ namespace pcit::panther{
 			TokenBuffer(const TokenBuffer& rhs) = delete;
 			
 			TokenBuffer(TokenBuffer&& rhs) noexcept 
-				: tokens(std::move(rhs.tokens)),
-				  string_literals(std::move(rhs.string_literals)),
+				: kinds(std::move(rhs.kinds)),
+				  locations(std::move(rhs.locations)),
+				  values(std::move(rhs.values)),
+				  value_blocks(std::move(rhs.value_blocks)),
+				  bracket_blocks(std::move(rhs.bracket_blocks)),
+				  bracket_matches(std::move(rhs.bracket_matches)),
+				  unclosed_brackets(std::move(rhs.unclosed_brackets)),
+				  first_unmatched_close_bracket(rhs.first_unmatched_close_bracket),
+				  lazy_value_interner(rhs.lazy_value_interner),
 				  is_locked(rhs.is_locked)
 				{};
 
+			auto operator=(const TokenBuffer&) = delete;
+			auto operator=(TokenBuffer&&) noexcept -> TokenBuffer& = default;
+
 
 			auto createToken(Token::Kind kind, Token::Location location) noexcept -> Token::ID;
 			auto createToken(Token::Kind kind, Token::Location location, bool value) noexcept -> Token::ID;
 			auto createToken(Token::Kind kind, Token::Location location, uint64_t value) noexcept -> Token::ID;
 			auto createToken(Token::Kind kind, Token::Location location, float64_t value) noexcept -> Token::ID;
-			auto createToken(Token::Kind kind, Token::Location location, std::string&& value) noexcept -> Token::ID;
 
-			EVO_NODISCARD auto get(Token::ID id) const noexcept -> const Token&;
-			EVO_NODISCARD auto get(Token::ID id)       noexcept ->       Token&;
+			// `value` must outlive the TokenBuffer 
+			// 	(the Tokenizer passes views into the source data or strings interned in the Context)
+			auto createToken(Token::Kind kind, Token::Location location, std::string_view value) noexcept -> Token::ID;
+
+			// `raw_value` is the text of a literal that the Tokenizer already validated (all of the token for
+			// 		numbers, or between the delimiters for text) and must outlive the TokenBuffer the same way as
+			// 		string values. `interner` is where text values are interned once decoded.
+			auto createLazyLiteralToken(
+				Token::Kind kind, Token::Location location, std::string_view raw_value, core::StringInterner& interner
+			) noexcept -> Token::ID;
+
+			// adds all of the tokens of `other` to the end
+			// 	(used to join the token buffers of chunks of a source that were tokenized in parallel)
+			auto append(const TokenBuffer& other) noexcept -> void;
+
+			// Used for incremental re-tokenization after the source data was edited:
+			// 	- tokens from `first_moved_token` onwards are moved `offset_shift` characters
+			// 	- string values that were views into `old_data` are changed to view the same characters in `new_data`
+			// 		(`old_data` is only used for its address so it doesn't need to still be valid)
+			auto moveToEditedData(
+				std::string_view old_data, std::string_view new_data, uint32_t first_moved_token, int64_t offset_shift
+			) noexcept -> void;
+
+			// Changes string values that are views into `data` to view the same string in `interner` instead
+			// 		(so the tokens no longer reference `data` and it can be freed). Lazy values stay lazy, with their
+			// 		raw text interned.
+			auto moveStringsToInterner(std::string_view data, core::StringInterner& interner) noexcept -> void;
+
+			// replaces the tokens [first_token, first_token + num_tokens) with all of the tokens of `replacement`
+			auto replaceTokens(Token::ID first_token, uint32_t num_tokens, const TokenBuffer& replacement) noexcept
+				-> void;
+
+			// decodes the value if it's lazy
+			EVO_NODISCARD auto get(Token::ID id) const noexcept -> Token;
+			EVO_NODISCARD auto operator[](Token::ID id) const noexcept -> Token { return this->get(id); };
+
+			EVO_NODISCARD auto getKind(Token::ID id) const noexcept -> Token::Kind {
+				return this->kinds[id.get()];
+			};
+			EVO_NODISCARD auto getLocation(Token::ID id) const noexcept -> const Token::Location& {
+				return this->locations[id.get()];
+			};
+
+			EVO_NODISCARD auto size() const noexcept -> size_t { return this->kinds.size(); };
 
-			EVO_NODISCARD auto operator[](Token::ID id) const noexcept -> const Token& { return this->get(id); };
-			EVO_NODISCARD auto operator[](Token::ID id)       noexcept ->       Token& { return this->get(id); };
 
-			EVO_NODISCARD auto size() const noexcept -> size_t { return this->tokens.size(); };
+			// The close bracket that matches an open bracket (`OpenParen`, `OpenBracket`, or `OpenBrace`), or nullopt
+			// 		if it's never closed. Lets a whole `(...)`, `[...]`, or `{...}` be skipped without going through
+			// 		the tokens in it.
+			EVO_NODISCARD auto getMatchingBracket(Token::ID open_bracket) const noexcept -> std::optional<Token::ID>;
+
+			struct UnbalancedBracket{
+				std::optional<Token::ID> openBracket;  // nullopt if nothing was open when the close bracket was found
+				std::optional<Token::ID> closeBracket; // nullopt if the open bracket is never closed
+			};
+
+			// The first close bracket that doesn't match the last bracket that was open (and the open bracket), or if
+			// 		there isn't one, the last open bracket that's never closed.
+			// 	(no more close brackets are matched after one that doesn't match)
+			EVO_NODISCARD auto getUnbalancedBracket() const noexcept -> std::optional<UnbalancedBracket>;
 
 			EVO_NODISCARD auto begin() const noexcept -> Token::ID::Iterator {
 				return Token::ID::Iterator(Token::ID(0));
 			};
 
 			EVO_NODISCARD auto end() const noexcept -> Token::ID::Iterator {
-				return Token::ID::Iterator(Token::ID(uint32_t(this->tokens.size())));
+				return Token::ID::Iterator(Token::ID(uint32_t(this->kinds.size())));
 			};
 
 
-			auto lock() noexcept -> void { this->is_locked = true; };
+			// No more tokens can be added once locked, so all of the spare capacity is freed
+			auto lock() noexcept -> void;
 			EVO_NODISCARD auto isLocked() const noexcept -> bool { return this->is_locked; };
 
-		
+
+			// in bytes (including spare capacity)
+			struct MemoryUsage{
+				size_t kinds = 0;
+				size_t locations = 0;
+				size_t values = 0;
+				size_t valueBlocks = 0;
+				size_t bracketIndex = 0;
+
+				EVO_NODISCARD auto total() const noexcept -> size_t {
+					return this->kinds + this->locations + this->values + this->valueBlocks + this->bracketIndex;
+				};
+
+				auto operator+=(const MemoryUsage& rhs) noexcept -> MemoryUsage& {
+					this->kinds        += rhs.kinds;
+					this->locations    += rhs.locations;
+					this->values       += rhs.values;
+					this->valueBlocks  += rhs.valueBlocks;
+					this->bracketIndex += rhs.bracketIndex;
+					return *this;
+				};
+			};
+
+			EVO_NODISCARD auto getMemoryUsage() const noexcept -> MemoryUsage;
+
+		private:
+			auto create_token_impl(Token::Kind kind, Token::Location location) noexcept -> Token::ID;
+			auto create_token_impl(Token::Kind kind, Token::Location location, const Token::Value& value) noexcept
+				-> Token::ID;
+
+			EVO_NODISCARD auto has_value(Token::ID id) const noexcept -> bool;
+			EVO_NODISCARD auto get_value_index(Token::ID id) const noexcept -> size_t;
+
+			// adds the token (which must be the last one) to the bracket index
+			auto index_bracket(Token::ID id) noexcept -> void;
+			auto rebuild_bracket_index() noexcept -> void;
+
+			EVO_NODISCARD auto is_lazy_value(Token::ID id) const noexcept -> bool;
+			EVO_NODISCARD auto decode_lazy_value(Token::ID id, size_t value_index) const noexcept -> Token::Value;
+
 		private:
-			std::vector<Token> tokens{};
-			std::vector<std::unique_ptr<std::string>> string_literals{};
+			static constexpr size_t VALUE_BLOCK_SIZE = 64;
+
+			struct ValueBlock{
+				uint64_t hasValueMask;
+				uint32_t numValuesBefore;
+
+				// Which of the values are still the raw text of a lazy literal.
+				// 	Bits are cleared (atomically) when the value is decoded, which can happen in `get()`.
+				mutable uint64_t lazyValueMask = 0;
+
+				// Which of the lazy values a thread has claimed to decode in `get()` (set atomically, and only
+				// 		ever for values that are lazy)
+				mutable uint64_t lazyValueClaimedMask = 0;
+			};
+
+			// the bits of a mask of [first_token, first_token + 64) (bits past the end are 0)
+			EVO_NODISCARD auto get_value_mask_bits(size_t first_token, uint64_t ValueBlock::* mask) const noexcept
+				-> uint64_t;
+			auto recount_values_before(size_t first_block) noexcept -> void;
+
+			// same as the value blocks, but of which tokens are open brackets
+			struct BracketBlock{
+				uint64_t openBracketMask;
+				uint32_t numOpenBracketsBefore;
+			};
+
+			struct UnclosedBracket{
+				Token::ID id;
+				uint32_t matchIndex; // in `bracket_matches`
+			};
+
+			static constexpr uint32_t NO_MATCHING_BRACKET = std::numeric_limits<uint32_t>::max();
+
+		private:
+			std::vector<Token::Kind> kinds{};
+			std::vector<Token::Location> locations{};
+			mutable std::vector<Token::Value> values{}; // lazy values are replaced when decoded
+			std::vector<ValueBlock> value_blocks{};
+
+			std::vector<BracketBlock> bracket_blocks{};
+			std::vector<uint32_t> bracket_matches{}; // ID of the close bracket of each open bracket (in order)
+			std::vector<UnclosedBracket> unclosed_brackets{}; // stack of the brackets that are still open
+			std::optional<UnbalancedBracket> first_unmatched_close_bracket{};
+
+			core::StringInterner* lazy_value_interner = nullptr;
 			bool is_locked = false;
+
+			friend class TokenCache;
 	};
 
 
@@ -0,0 +1,75 @@
+//////////////////////////////////////////////////////////////////////
+//                                                                  //
+// Part of the PCIT-CPP, under the Apache License v2.0              //
+// You may not use this file except in compliance with the License. //
+// See `http://www.apache.org/licenses/LICENSE-2.0` for info        //
+//                                                                  //
+//////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+
+#include <array>
+#include <memory>
+
+#include <Evo.h>
+#include <PCIT_core.h>
+
+#include "./Context.h"
+#include "./Token.h"
+
+namespace pcit::panther{
+
+
+	class Tokenizer;
+
+
+	// Pull-based cursor over the tokens of a source, tokenized as they're asked for.
+	// Only up to `MAX_LOOKAHEAD` tokens are ever held (in a ring buffer), so memory doesn't grow with the size of
+	// 		the source, and whatever consumes the tokens (such as a parser) can run as the source is tokenized.
+	// Gives the same tokens as tokenizing the whole source (debug builds check it for every source the Context
+	// 		tokenizes), which stays the faster way to get all of them at once.
+	class TokenStream{
+		public:
+			static constexpr size_t MAX_LOOKAHEAD = 8;
+
+		public:
+			TokenStream(Context& context, Source::ID source_id) noexcept;
+			~TokenStream() noexcept;
+
+			TokenStream(const TokenStream&) = delete;
+			TokenStream(TokenStream&&) = delete;
+
+			// the token `num_ahead` tokens after the next one, or nullopt if there isn't one (or tokenizing errored)
+			EVO_NODISCARD auto peek(size_t num_ahead = 0) noexcept -> std::optional<Token>;
+
+			// consumes the next token, or returns nullopt if there isn't one (or tokenizing errored)
+			EVO_NODISCARD auto next() noexcept -> std::optional<Token>;
+
+			// consumes the next token without returning it (there must be one)
+			auto skip() noexcept -> void;
+
+			// every token has been consumed (or tokenizing errored)
+			EVO_NODISCARD auto atEnd() noexcept -> bool { return this->peek().has_value() == false; };
+
+			// if true, the error was already reported and no more tokens are given
+			EVO_NODISCARD auto errored() const noexcept -> bool { return this->has_errored; };
+
+		private:
+			// returns false if there are no more tokens
+			EVO_NODISCARD auto buffer_next_token() noexcept -> bool;
+
+		private:
+			std::unique_ptr<Tokenizer> tokenizer; // so the Tokenizer doesn't have to be public
+
+			std::array<std::optional<Token>, MAX_LOOKAHEAD> lookahead{};
+			size_t first_lookahead = 0;
+			size_t num_lookahead = 0;
+
+			bool reached_end = false;
+			bool has_errored = false;
+	};
+
+
+};
@@ -29,11 +29,16 @@ namespace pcit::panther{
 		TokInvalidNumDigit,                 // T8
 		TokLiteralNumTooBig,                // T9
 		TokUnknownFailureToTokenizeNum,     // T10
+		TokLiteralIntNegativeExponent,      // T11
+		TokUnmatchedCloseBracket,           // T12
+		TokUnclosedBracket,                 // T13
 
 		SemaUnknownIdentifier, // S1
 
 		MiscFileDoesNotExist, // M1
 		MiscLoadFileFailed,   // M2
+		MiscNoFilesMatched,   // M3
+		MiscInvalidUTF8,      // M4
 	};
 
 	using Diagnostic = core::DiagnosticImpl<DiagnosticCode, Source::Location>;
@@ -51,11 +56,16 @@ namespace pcit::panther{
 			break; case DiagnosticCode::TokInvalidNumDigit:                 return "T8";
 			break; case DiagnosticCode::TokLiteralNumTooBig:                return "T9";
 			break; case DiagnosticCode::TokUnknownFailureToTokenizeNum:     return "T10";
+			break; case DiagnosticCode::TokLiteralIntNegativeExponent:      return "T11";
+			break; case DiagnosticCode::TokUnmatchedCloseBracket:           return "T12";
+			break; case DiagnosticCode::TokUnclosedBracket:                 return "T13";
 
 			break; case DiagnosticCode::SemaUnknownIdentifier: return "S1";
 
 			break; case DiagnosticCode::MiscFileDoesNotExist: return "M1";
 			break; case DiagnosticCode::MiscLoadFileFailed: return "M2";
+			break; case DiagnosticCode::MiscNoFilesMatched: return "M3";
+			break; case DiagnosticCode::MiscInvalidUTF8: return "M4";
 		};
 		
 		evo::debugFatalBreak("Unknown or unsupported pcit::panther::DiagnosticCode");
@@ -58,4 +58,37 @@ project "pthr"
 	}
 
 
-project "*"
\ No newline at end of file
+project "*"
+
+
+
+project "pthr_bench"
+	kind "ConsoleApp"
+	-- staticruntime "On"
+	
+
+	targetdir(target.bin)
+	objdir(target.obj)
+
+	files {
+		"./bench/**.cpp",
+	}
+
+	
+
+	includedirs{
+		(config.location .. "/libs"),
+		(config.location .. "/PCIT_core/include"),
+		
+
+		"./include/",
+	}
+
+	links{
+		"Evo",
+		"PCIT_core",
+		"Panther",
+	}
+
+
+project "*"
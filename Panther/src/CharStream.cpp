@@ -9,6 +9,8 @@
 
 #include "./CharStream.h"
 
+#include "./char_scanning.h"
+
 namespace pcit::panther{
 	
 
@@ -30,7 +32,7 @@ namespace pcit::panther{
 		evo::debugAssert(this->at_end() == false, "Already at end");
 
 		const char current_char = this->peek();
-		this->skip_single();
+		this->cursor += 1;
 		return current_char;
 	};
 
@@ -39,34 +41,20 @@ namespace pcit::panther{
 		evo::debugAssert(this->cursor + ammount <= this->data.size(), "Skipping past the end of the data");
 		evo::debugAssert(ammount != 0, "Cannot skip 0 forward");
 
-		for(size_t i = 0; i < ammount; i+=1){
-			this->skip_single();
-		}
+		this->cursor += ammount;
 	};
 
 
-	auto CharStream::skip_single() noexcept -> void {
-		evo::debugAssert(this->at_end() == false, "Already at end");
-
-		const char current_char = this->peek();
-
-		if(current_char == '\n'){
-			this->line += 1;
-			this->collumn = 1;
-
-		}else if(current_char == '\r'){
-			this->line += 1;
-			this->collumn = 1;
-
-			if(this->at_end() == false && this->peek() == '\n'){
-				this->cursor += 1;	
-			}
+	auto CharStream::skip_whitespace() noexcept -> void {
+		this->cursor += char_scanning::findWhitespaceEnd(this->remaining());
+	};
 
-		}else{
-			this->collumn += 1;
-		}
+	auto CharStream::skip_identifier_chars() noexcept -> void {
+		this->cursor += char_scanning::findIdentifierEnd(this->remaining());
+	};
 
-		this->cursor += 1;
+	auto CharStream::skip_until_either(char a, char b) noexcept -> void {
+		this->cursor += char_scanning::findFirstOf(this->remaining(), a, b);
 	};
 
 
@@ -21,28 +21,39 @@ namespace pcit::panther{
 	class CharStream{
 		public:
 			CharStream(std::string_view src_data) noexcept : data(src_data) {};
+
+			// starts at `start_offset` (offsets are still from the beginning of `src_data`)
+			CharStream(std::string_view src_data, size_t start_offset) noexcept
+				: data(src_data), cursor(start_offset) {};
 			~CharStream() = default;
 
 			EVO_NODISCARD auto peek(size_t ammount_forward = 0) const noexcept -> char;
 			EVO_NODISCARD auto peek_raw_ptr() const noexcept -> const char*;
+			EVO_NODISCARD auto cursor_raw_ptr() const noexcept -> const char* {
+				return this->data.data() + this->cursor;
+			};
 			EVO_NODISCARD auto next() noexcept -> char;
 			auto skip(size_t ammount) noexcept -> void;
 
+			// these skip runs of characters with the vectorized kernels in `char_scanning.h` (may skip 0 characters)
+			auto skip_whitespace() noexcept -> void;
+			auto skip_identifier_chars() noexcept -> void;
+			auto skip_until_either(char a, char b) noexcept -> void; // stops at the first `a` or `b` (or the end)
+
 			EVO_NODISCARD auto at_end() const noexcept -> bool { return this->cursor == this->data.size(); };
 			EVO_NODISCARD auto ammount_left() const noexcept -> size_t { return this->data.size() - this->cursor; };
 
-			EVO_NODISCARD auto get_line() const noexcept -> uint32_t { return this->line; };
-			EVO_NODISCARD auto get_collumn() const noexcept -> uint32_t { return this->collumn; };
+			// line and collumn are resolved from the offset by the Source (only needed when it's actually used)
+			EVO_NODISCARD auto get_offset() const noexcept -> uint32_t { return uint32_t(this->cursor); };
 
 		private:
-			EVO_NODISCARD auto skip_single() noexcept -> void;
+			EVO_NODISCARD auto remaining() const noexcept -> std::string_view {
+				return this->data.substr(this->cursor);
+			};
 	
 		private:
 			std::string_view data;
 			size_t cursor = 0;
-
-			uint32_t line = 1;
-			uint32_t collumn = 1;
 	};
 
 
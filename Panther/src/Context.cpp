@@ -9,14 +9,50 @@
 
 #include "../include/Context.h"
 
+#include <ranges>
+#include <unordered_map>
+
+#include "../include/TokenStream.h"
 #include "./Tokenizer.h"
+#include "./TokenCache.h"
+#include "./glob.h"
 
 namespace pcit::panther{
 
+	thread_local Context::Worker* Context::current_worker = nullptr;
+
+
+	EVO_NODISCARD static auto read_file_data(const fs::path& path) noexcept -> std::optional<std::string> {
+		auto file = evo::fs::File();
+
+		const bool open_res = file.open(path.string(), evo::fs::FileMode::Read);
+		if(open_res == false){
+			file.close();
+			return std::nullopt;
+		}
+
+		evo::Result<std::string> data_res = file.read();
+		file.close();
+		if(data_res.isError()){ return std::nullopt; }
+
+		return std::move(data_res.value());
+	};
+
 
 	Context::Context(DiagnosticCallback diagnostic_callback, const Config& _config) noexcept 
-		: callback(diagnostic_callback), config(_config) {
+		: callback(diagnostic_callback), config(_config), profile_start_time(std::chrono::steady_clock::now()) {
 		evo::debugAssert(this->config.maxNumErrors > 0, "Max num errors cannot be 0");
+
+		// one for each worker (or the single-threaded worker) and one for anything done outside of a worker
+		const size_t num_thread_buffers = std::max(size_t(this->config.numThreads), size_t(1)) + 1;
+
+		if(this->config.immediateDiagnostics == false){
+			this->diagnostic_buffers.resize(num_thread_buffers);
+		}
+
+		if(this->is_collecting_profile_data()){
+			this->profile_buffers.resize(num_thread_buffers);
+		}
 	};
 
 
@@ -51,24 +87,27 @@ namespace pcit::panther{
 		static constexpr auto worker_controller_impl = [](
 			std::stop_token stop_token, Worker& worker
 		) noexcept -> void {
+			current_worker = &worker;
+
 			while(stop_token.stop_requested() == false){
-				worker.get_task();
+				worker.get_task(stop_token);
 			};
 
-			worker.done();
+			current_worker = nullptr;
 		};
-			
 
+
+		// all workers need to exist before any threads start as workers steal from each other
 		for(size_t i = 0; i < this->config.numThreads; i+=1){
-			Worker& new_worker = this->workers.emplace_back(this);
+			this->workers.emplace_back(this, i);
+		}
 
-			auto worker_controller = [context = this, &new_worker](std::stop_token stop_token) noexcept -> void {
-				worker_controller_impl(stop_token, new_worker);
+		for(Worker& worker : this->workers){
+			auto worker_controller = [context = this, &worker](std::stop_token stop_token) noexcept -> void {
+				worker_controller_impl(stop_token, worker);
 			};
 
-			new_worker.getThread() = std::jthread(worker_controller);
-			this->num_threads_running += 1;
-			new_worker.getThread().detach();
+			worker.getThread() = std::jthread(worker_controller);
 		}
 
 		this->emitDebug("pcit::panther::Context started up threads");
@@ -80,53 +119,55 @@ namespace pcit::panther{
 
 		const bool already_shutting_down = this->shutting_down_threads.test_and_set();
 		if(already_shutting_down){ return; }
-		EVO_DEFER([&]() noexcept -> void { this->shutting_down_threads.clear(); } );
 
-		if(this->workers.empty()){ return; }
+		this->shutdown_threads_impl();
+	};
+
+
+	auto Context::shutdown_threads_impl() noexcept -> void {
+		evo::debugAssert(this->shutting_down_threads.test(), "`shutting_down_threads` should be set by the caller");
 
+		// requesting stop also wakes any worker parked on `work_available_cv`
 		for(Worker& worker : workers){
 			worker.getThread().request_stop();
 		}
 
-		while(this->num_threads_running != 0){};
+		for(Worker& worker : workers){
+			worker.getThread().join();
+		}
 
 		this->workers.clear();
 
+		// any tasks that were still queued were dropped with the workers, so release anyone waiting on them
+		this->num_queued_tasks = 0;
+		this->num_unfinished_tasks = 0;
+		this->num_unfinished_tasks.notify_all();
+
+		// every worker has stopped, so nothing else can be added to the diagnostic buffers
+		this->flush_diagnostics();
+		this->release_pending_source_data();
+
 		this->task_group_running = false;
 
 		this->emitDebug("pcit::panther::Context shutdown threads");
+
+		this->shutting_down_threads.clear();
 	};
 
 
 	auto Context::waitForAllTasks() noexcept -> void {
 		evo::debugAssert(this->isMultiThreaded(), "Context is not set to be multi-threaded");
-		evo::debugAssert(this->threadsRunning(), "Threads are not running");
-		evo::debugAssert(
-			this->hasHitFailCondition() == false, "Context hit a fail condition, threads should be shutdown instead"
-		);
 
-		if(this->shutting_down_threads.test()){ return; }
+		evo::debugAssert(this->threadsRunning(), "Threads are not running");
 
-		while(this->tasks.empty() == false){
-			std::this_thread::sleep_for(std::chrono::milliseconds(32));
+		size_t num_unfinished_tasks = this->num_unfinished_tasks.load();
+		while(num_unfinished_tasks != 0){
+			this->num_unfinished_tasks.wait(num_unfinished_tasks);
+			num_unfinished_tasks = this->num_unfinished_tasks.load();
 		};
 
-		while(true){
-			bool all_done = true;
-
-			for(const Worker& worker : this->workers){
-				if(worker.isWorking()){
-					all_done = false;
-					break;
-				}
-			}
-
-			if(all_done){
-				break;
-			}
-
-			std::this_thread::sleep_for(std::chrono::milliseconds(32));
-		};
+		this->flush_diagnostics();
+		this->release_pending_source_data();
 
 		this->task_group_running = false;
 	};
@@ -135,21 +176,18 @@ namespace pcit::panther{
 
 
 	auto Context::loadFiles(evo::ArrayProxy<fs::path> file_paths) noexcept -> void {
-		evo::debugAssert(
-			this->isSingleThreaded() || this->threadsRunning(),
-			"Context is set to be multi-threaded, but threads are not running"
-		);
+		this->add_load_file_tasks(file_paths, TaskPhase::Load);
+	};
 
-		evo::debugAssert(this->task_group_running == false, "Task group already running");
 
+	auto Context::tokenizeLoadedFiles() noexcept -> void {
+		evo::debugAssert(this->task_group_running == false, "Task group already running");
 
 		this->task_group_running = true;
 
-		// TODO: maybe check if any files had been loaded yet
-		this->getSourceManager().reserveSources(file_paths.size());
-
-		for(const fs::path& file_path : file_paths){
-			this->tasks.emplace(std::make_unique<Task>(LoadFileTask(file_path)));
+		for(Source::ID source_id : this->src_manager){
+			if(this->src_manager.getSource(source_id).isTokenized()){ continue; }
+			this->add_task(TokenizeFileTask(source_id, TaskPhase::Tokenize));
 		}
 
 		if(this->isSingleThreaded()){
@@ -158,184 +196,1386 @@ namespace pcit::panther{
 	};
 
 
-	auto Context::tokenizeLoadedFiles() noexcept -> void {
-		evo::debugAssert(this->task_group_running == false, "Task group already running");
+	auto Context::loadAndTokenizeFiles(evo::ArrayProxy<fs::path> file_paths) noexcept -> void {
+		this->add_load_file_tasks(file_paths, TaskPhase::Tokenize);
+	};
 
-		{
-			const auto lock_guard = std::lock_guard(this->src_manager_mutex);
-			
-			this->task_group_running = true;
 
-			for(Source& source : this->src_manager.sources){
-				this->tasks.emplace(std::make_unique<Task>(TokenizeFileTask(source.getID())));
-			}
-		}
+	auto Context::loadFilesMatching(evo::ArrayProxy<fs::path> patterns) noexcept -> void {
+		this->add_discover_files_tasks(patterns, TaskPhase::Load, false);
+	};
 
-		if(this->isSingleThreaded()){
-			this->consume_tasks_single_threaded();
-		}
+	auto Context::loadAndTokenizeFilesMatching(evo::ArrayProxy<fs::path> patterns) noexcept -> void {
+		this->add_discover_files_tasks(patterns, TaskPhase::Tokenize, false);
 	};
 
+	auto Context::loadAndTokenizeNewFilesMatching(evo::ArrayProxy<fs::path> patterns) noexcept -> void {
+		this->add_discover_files_tasks(patterns, TaskPhase::Tokenize, true);
+	};
 
 
+	auto Context::editSource(Source::ID source_id, evo::ArrayProxy<Source::Edit> edits) noexcept -> bool {
+		const bool edit_succeeded = this->edit_source_impl(source_id, edits, this->task_group_stop_source.get_token());
 
-	auto Context::emit_diagnostic_impl(const Diagnostic& diagnostic) noexcept -> void {
-		const auto lock_guard = std::lock_guard(this->callback_mutex);
+		// not part of a task group, so there's nothing else to deliver the diagnostics
+		this->flush_diagnostics();
 
-		this->callback(*this, diagnostic);
+		return edit_succeeded;
 	};
 
 
-	auto Context::notify_task_errored() noexcept -> void {
-		if(this->num_errors >= this->config.maxNumErrors){
-			this->hit_fail_condition = true;
-		}
+	auto Context::reloadSourceFile(Source::ID source_id) noexcept -> bool {
+		const bool reload_succeeded = this->reload_source_file_impl(
+			source_id, this->task_group_stop_source.get_token()
+		);
 
-		if(this->hasHitFailCondition() && this->isMultiThreaded()){
-			// in a separate thread to prevent process from dead-locking when waiting for threads
-			//  	(the worker thread that calls this function is never able to call its `done` function)
-			std::thread([&]() noexcept -> void {
-				this->shutdownThreads();
-			}).detach();
-		}
+		// not part of a task group, so there's nothing else to deliver the diagnostics
+		this->flush_diagnostics();
+		this->release_pending_source_data();
+
+		return reload_succeeded;
 	};
 
 
-	auto Context::consume_tasks_single_threaded() noexcept -> void {
-		evo::debugAssert(this->isSingleThreaded(), "Context is not set to be single threaded");
+	#if defined(PCIT_BUILD_DEBUG)
+		// The tokens after an edit (or joining chunks) have to be the same as tokenizing all of the source at once
+		// 		(would catch, for example, `Tokenizer::MAX_LOOKAHEAD` being smaller than how far the tokenizer
+		// 		actually looks)
+		EVO_NODISCARD static auto matches_full_tokenize(Context& context, const Source& source) noexcept -> bool {
+			auto tokenizer = Tokenizer(context, source.getID());
+			const evo::Result<TokenBuffer> result = tokenizer.tokenize();
+			if(result.isError()){ return false; }
 
-		auto worker = Worker(this);
+			const TokenBuffer& tokens = source.getTokenBuffer();
+			if(result.value().size() != tokens.size()){ return false; }
 
-		while(this->tasks.empty() == false && this->hasHitFailCondition() == false){
-			worker.get_task_single_threaded();
+			for(Token::ID token_id : tokens){
+				if(result.value().getKind(token_id) != tokens.getKind(token_id)){ return false; }
+
+				const Token::Location& full_location = result.value().getLocation(token_id);
+				const Token::Location& location = tokens.getLocation(token_id);
+				if(location.offset != full_location.offset || location.length != full_location.length){
+					return false;
+				}
+			}
+
+			return true;
 		};
 
-		this->task_group_running = false;
-	};
+		// `TokenStream` has to give the same tokens as tokenizing the whole source (which `source` already was)
+		EVO_NODISCARD static auto matches_token_stream(Context& context, const Source& source) noexcept -> bool {
+			auto token_stream = TokenStream(context, source.getID());
+			const TokenBuffer& tokens = source.getTokenBuffer();
 
+			for(Token::ID token_id : tokens){
+				const std::optional<Token> streamed_token = token_stream.next();
+				if(streamed_token.has_value() == false){ return false; }
 
-	//////////////////////////////////////////////////////////////////////
-	// Worker
+				if(streamed_token->getKind() != tokens.getKind(token_id)){ return false; }
+
+				const Token::Location& location = tokens.getLocation(token_id);
+				const Token::Location& streamed_location = streamed_token->getLocation();
+				if(location.offset != streamed_location.offset || location.length != streamed_location.length){
+					return false;
+				}
+			}
 
+			return token_stream.atEnd() && token_stream.errored() == false;
+		};
+	#endif
 
-	auto Context::Worker::done() noexcept -> void {
-		this->is_working = false;
-		this->context->num_threads_running -= 1;
-	};
 
+	auto Context::edit_source_impl(
+		Source::ID source_id, evo::ArrayProxy<Source::Edit> edits, const std::stop_token& stop_token
+	) noexcept -> bool {
+		if(edits.empty()){ return true; }
 
-	auto Context::Worker::get_task() noexcept -> void {
-		evo::debugAssert(this->context->isMultiThreaded(), "Context is not set to be multi-threaded");
+		Source& source = this->src_manager.getSource(source_id);
+		evo::debugAssert(source.isDataReleased() == false, "Cannot edit a source that had its data released");
+		const Source::EditedRange edited_range = source.apply_edits(edits);
 
-		auto task = std::unique_ptr<Task>();
+		if(this->check_source_is_valid_utf8(source) == false){
+			source.token_buffer = TokenBuffer();
+			source.is_tokenized = false;
+			return false;
+		}
 
-		{
-			const auto lock_guard = std::lock_guard(this->context->tasks_mutex);
+		// keep every token that ends far enough before the edit that it couldn't have been changed by it, and
+		// 		re-tokenize from the end of the last of them
+		const auto token_indices = std::views::iota(uint32_t(0), edited_range.firstMovedToken);
+		const uint32_t num_kept_tokens = *std::ranges::partition_point(token_indices, [&](uint32_t token_index){
+			const Token::Location& location = source.token_buffer.getLocation(Token::ID(token_index));
+			return size_t(location.offset) + location.length + Tokenizer::MAX_LOOKAHEAD <= edited_range.start;
+		});
 
-			if(this->context->tasks.empty() == false){
-				task.reset(this->context->tasks.front().release());
-				this->context->tasks.pop();
-			}else{
-				this->context->task_group_running = false;
-			}
+		const uint32_t retokenize_start = [&]() noexcept -> uint32_t {
+			if(num_kept_tokens == 0){ return 0; }
+			const Token::Location& location = source.token_buffer.getLocation(Token::ID(num_kept_tokens - 1));
+			return location.offset + location.length;
+		}();
+
+		auto tokenizer = Tokenizer(*this, source_id, retokenize_start, uint32_t(source.getData().size()), stop_token);
+		evo::Result<Tokenizer::ResyncResult> result = 
+			tokenizer.tokenizeUntilResync(source.token_buffer, edited_range.firstMovedToken);
+
+		// errored sources are left with no tokens (so the next edit re-tokenizes the whole source)
+		if(result.isError()){
+			source.token_buffer = TokenBuffer();
+			source.is_tokenized = false;
+			return false;
 		}
 
-		if(task == nullptr){
-			this->is_working = false;
-			std::this_thread::sleep_for(std::chrono::milliseconds(32));
+		source.token_buffer.replaceTokens(
+			Token::ID(num_kept_tokens), result.value().resyncToken - num_kept_tokens, result.value().tokenBuffer
+		);
 
-		}else{
-			this->is_working = true;
-			this->run_task(*task);
+		if(this->check_brackets_are_balanced(source, source.token_buffer) == false){
+			source.token_buffer = TokenBuffer();
+			source.is_tokenized = false;
+			return false;
 		}
+
+		this->with_profile_buffer([&](ProfileBuffer& profile_buffer) noexcept -> void {
+			profile_buffer.counters.tokensProduced += result.value().tokenBuffer.size();
+		});
+
+		this->emitTrace(
+			"Re-tokenized edited file: \"{}\" (re-tokenized {} tokens)",
+			source.getLocationAsString(),
+			result.value().tokenBuffer.size()
+		);
+
+		#if defined(PCIT_BUILD_DEBUG)
+			evo::debugAssert(
+				matches_full_tokenize(*this, source), "An edit gave different tokens than a full tokenize"
+			);
+		#endif
+
+		source.is_tokenized = true;
+		return true;
 	};
 
 
-	auto Context::Worker::get_task_single_threaded() noexcept -> void {
-		evo::debugAssert(this->context->isSingleThreaded(), "Context is not set to be single-threaded");
 
-		this->is_working = true;
 
-		if(this->context->tasks.empty() == false){
-			auto task = std::unique_ptr<Task>(this->context->tasks.front().release());
-			this->context->tasks.pop();
-			this->run_task(*task);
+	auto Context::reload_source_file_impl(Source::ID source_id, const std::stop_token& stop_token) noexcept -> bool {
+		Source& source = this->src_manager.getSource(source_id);
+
+		evo::debugAssert(source.locationIsPath(), "Source was not loaded from a file");
+		evo::debugAssert(source.isMemoryMapped() == false, "Cannot reload a memory-mapped source");
+
+		std::optional<std::string> new_data = read_file_data(source.getLocationPath());
+		if(new_data.has_value() == false){
+			this->num_errors += 1;
+			this->emit_diagnostic_internal(
+				Diagnostic::Level::Error, Diagnostic::Code::MiscLoadFileFailed, std::nullopt,
+				std::format("Failed to reload file: \"{}\"", source.getLocationAsString())
+			);
+			return false;
+		}
+
+		const auto finish = [&](bool reloaded) noexcept -> bool {
+			if(reloaded && this->config.releaseSourceData){ this->prepare_source_data_release(source_id); }
+			return reloaded;
+		};
+
+		// there's nothing to compare the file to, so all of it is re-tokenized
+		if(source.isDataReleased()){
+			source.replace_released_data(std::move(*new_data));
+			return finish(this->retokenize_source(source_id, stop_token));
+		}
+
+		// the changed part is everything between the common prefix and the common suffix
+		// 	(the byte order mark isn't part of the data of a source, so it's not compared)
+		const std::string_view old_data = source.getData();
+
+		std::string_view new_data_view = *new_data;
+		if(new_data_view.starts_with(Source::UTF8_BYTE_ORDER_MARK)){
+			new_data_view.remove_prefix(Source::UTF8_BYTE_ORDER_MARK.size());
+		}
+
+		const size_t prefix_size = size_t(
+			std::mismatch(old_data.begin(), old_data.end(), new_data_view.begin(), new_data_view.end()).first
+			- old_data.begin()
+		);
+		if(prefix_size == old_data.size() && prefix_size == new_data_view.size()){
+			// a source with no tokens may have errored the last time it was tokenized (so it still has to be)
+			if(source.getTokenBuffer().size() == 0 && old_data.empty() == false){
+				return finish(this->retokenize_source(source_id, stop_token));
+			}
+
+			return finish(true);
 		}
 
-		this->is_working = false;
+		const size_t max_suffix_size = std::min(old_data.size(), new_data_view.size()) - prefix_size;
+		const size_t suffix_size = size_t(
+			std::mismatch(old_data.rbegin(), old_data.rbegin() + max_suffix_size, new_data_view.rbegin()).first
+			- old_data.rbegin()
+		);
+
+		const auto edit = Source::Edit(
+			uint32_t(prefix_size),
+			uint32_t(old_data.size() - prefix_size - suffix_size),
+			new_data_view.substr(prefix_size, new_data_view.size() - prefix_size - suffix_size)
+		);
+
+		return finish(this->edit_source_impl(source_id, edit, stop_token));
 	};
 
 
-	auto Context::Worker::run_task(const Task& task) noexcept -> void {
-		const bool run_task_res = task.visit([&](auto& value) noexcept -> bool {
-			using ValueT = std::decay_t<decltype(value)>;
+	auto Context::retokenize_source(Source::ID source_id, const std::stop_token& stop_token) noexcept -> bool {
+		Source& source = this->src_manager.getSource(source_id);
 
-			     if constexpr(std::is_same_v<ValueT, LoadFileTask>){     return this->run_load_file(value);     }
-			else if constexpr(std::is_same_v<ValueT, TokenizeFileTask>){ return this->run_tokenize_file(value); }
+		if(this->check_source_is_valid_utf8(source) == false){
+			source.token_buffer = TokenBuffer();
+			source.is_tokenized = false;
+			return false;
+		}
+
+		auto tokenizer = Tokenizer(*this, source_id, stop_token);
+		evo::Result<TokenBuffer> result = tokenizer.tokenize();
+
+		// errored sources are left with no tokens (same as `edit_source_impl()`)
+		if(result.isError() || this->check_brackets_are_balanced(source, result.value()) == false){
+			source.token_buffer = TokenBuffer();
+			source.is_tokenized = false;
+			return false;
+		}
+
+		source.token_buffer = std::move(result.value());
+		source.is_tokenized = true;
+
+		this->with_profile_buffer([&](ProfileBuffer& profile_buffer) noexcept -> void {
+			profile_buffer.counters.tokensProduced += source.token_buffer.size();
 		});
 
-		if(run_task_res == false){
-			this->context->notify_task_errored();
-		}	
+		this->emitTrace("Re-tokenized file: \"{}\"", source.getLocationAsString());
+
+		return true;
 	};
 
 
+	auto Context::check_source_is_valid_utf8(const Source& source) noexcept -> bool {
+		const std::optional<uint32_t> invalid_utf8_offset = source.getInvalidUTF8Offset();
+		if(invalid_utf8_offset.has_value() == false){ return true; }
 
-	auto Context::Worker::run_load_file(const LoadFileTask& task) noexcept -> bool {
-		if(evo::fs::exists(task.path.string()) == false){
-			this->context->num_errors += 1;
-			this->context->emit_diagnostic_internal(
-				Diagnostic::Level::Error, Diagnostic::Code::MiscFileDoesNotExist, std::nullopt,
-				std::format("File \"{}\" does not exist", task.path.string())
+		this->emitError(
+			Diagnostic::Code::MiscInvalidUTF8,
+			source.getLocation(*invalid_utf8_offset),
+			std::format(
+				"Source is not valid UTF-8 (invalid byte 0x{:02X})", uint8_t(source.getData()[*invalid_utf8_offset])
+			)
+		);
+
+		return false;
+	};
+
+
+	auto Context::check_brackets_are_balanced(const Source& source, const TokenBuffer& token_buffer) noexcept -> bool {
+		const std::optional<TokenBuffer::UnbalancedBracket> unbalanced_bracket = token_buffer.getUnbalancedBracket();
+		if(unbalanced_bracket.has_value() == false){ return true; }
+
+		const auto get_token_source_location = [&](Token::ID token_id) noexcept -> Source::Location {
+			return token_buffer[token_id].getSourceLocation(source);
+		};
+
+		if(unbalanced_bracket->closeBracket.has_value() == false){
+			const Token::ID open_bracket = *unbalanced_bracket->openBracket;
+
+			this->emitError(
+				Diagnostic::Code::TokUnclosedBracket,
+				get_token_source_location(open_bracket),
+				std::format("Unclosed \"{}\"", Token::printKind(token_buffer.getKind(open_bracket)))
 			);
 			return false;
 		}
 
-		auto file = evo::fs::File();
+		const Token::ID close_bracket = *unbalanced_bracket->closeBracket;
+		const std::string_view close_bracket_str = Token::printKind(token_buffer.getKind(close_bracket));
 
-		const bool open_res = file.open(task.path.string(), evo::fs::FileMode::Read);
-		if(open_res == false){
-			file.close();
-			this->context->num_errors += 1;
-			this->context->emit_diagnostic_internal(
-				Diagnostic::Level::Error, Diagnostic::Code::MiscLoadFileFailed, std::nullopt,
-				std::format("Failed to load file: \"{}\"", task.path.string())
+		if(unbalanced_bracket->openBracket.has_value() == false){
+			this->emitError(
+				Diagnostic::Code::TokUnmatchedCloseBracket,
+				get_token_source_location(close_bracket),
+				std::format("Unmatched \"{}\" (there's no open bracket to close)", close_bracket_str)
 			);
 			return false;
 		}
 
-		const evo::Result<std::string> data_res = file.read();
-		file.close();
-		if(data_res.isError()){
-			this->context->num_errors += 1;
-			this->context->emit_diagnostic_internal(
-				Diagnostic::Level::Error, Diagnostic::Code::MiscLoadFileFailed, std::nullopt,
-				std::format("Failed to load file: \"{}\"", task.path.string())
-			);
-			return false;
+		const Token::ID open_bracket = *unbalanced_bracket->openBracket;
+
+		this->emitError(
+			Diagnostic::Code::TokUnmatchedCloseBracket,
+			get_token_source_location(close_bracket),
+			std::format(
+				"Unmatched \"{}\" (expected the \"{}\" to be closed first)",
+				close_bracket_str,
+				Token::printKind(token_buffer.getKind(open_bracket))
+			),
+			std::vector<Diagnostic::Info>{
+				Diagnostic::Info("Bracket that was opened here:", get_token_source_location(open_bracket)),
+			}
+		);
+		return false;
+	};
+
+
+	auto Context::prepare_source_data_release(Source::ID source_id) noexcept -> void {
+		Source& source = this->src_manager.getSource(source_id);
+		if(source.is_data_release_pending){ return; }
+
+		source.token_buffer.moveStringsToInterner(source.getData(), this->string_interner);
+		source.token_buffer.lock();
+
+		source.is_data_release_pending = true;
+		this->num_sources_pending_data_release += 1;
+	};
+
+
+	auto Context::release_pending_source_data() noexcept -> void {
+		if(this->num_sources_pending_data_release == 0){ return; }
+
+		for(Source::ID source_id : this->src_manager){
+			Source& source = this->src_manager.getSource(source_id);
+			if(source.is_data_release_pending){ source.release_data(); }
 		}
 
-		this->context->emitTrace("Loaded file: \"{}\"", task.path.string());
+		this->num_sources_pending_data_release = 0;
+	};
 
-		const auto lock_guard = std::lock_guard(this->context->src_manager_mutex);
-		this->context->getSourceManager().addSource(std::move(task.path), std::move(data_res.value()));
-		return true;
+
+	auto Context::reloadSourceFiles(evo::ArrayProxy<Source::ID> source_ids) noexcept -> void {
+		evo::debugAssert(
+			this->isSingleThreaded() || this->threadsRunning(),
+			"Context is set to be multi-threaded, but threads are not running"
+		);
+		evo::debugAssert(this->task_group_running == false, "Task group already running");
+
+		this->task_group_running = true;
+
+		for(Source::ID source_id : source_ids){
+			this->add_task(ReloadFileTask(source_id));
+		}
+
+		if(this->isSingleThreaded()){
+			this->consume_tasks_single_threaded();
+		}
 	};
 
 
+	auto Context::clearErrors() noexcept -> void {
+		evo::debugAssert(this->task_group_running == false, "Cannot clear errors while a task group is running");
 
-	auto Context::Worker::run_tokenize_file(const TokenizeFileTask& task) noexcept -> bool {
-		auto tokenizer = Tokenizer(*this->context, task.source_id);
+		this->num_errors = 0;
+		this->hit_fail_condition = false;
 
-		evo::Result<TokenBuffer> result = tokenizer.tokenize();
-		if(result.isError()){ return false; }
+		if(this->task_group_stop_source.stop_requested()){
+			this->task_group_stop_source = std::stop_source();
+		}
+	};
 
-		const SourceManager& source_manager = this->context->getSourceManager();
-		const Source& source = source_manager.getSource(task.source_id);
-		std::construct_at(&source.token_buffer, std::move(result.value()));
 
-		this->context->emitTrace("Tokenized file: \"{}\"", source.getLocationAsString());
-		return true;
+	auto Context::reset() noexcept -> void {
+		evo::debugAssert(this->task_group_running == false, "Cannot reset while a task group is running");
+
+		this->src_manager.clear();
+		this->string_interner.clear();
+		this->discovered_files.clear();
+		this->clearErrors();
+
+		for(ProfileBuffer& profile_buffer : this->profile_buffers){
+			profile_buffer.events.clear();
+			profile_buffer.counters = ProfileData::Counters();
+		}
+		this->profile_start_time = std::chrono::steady_clock::now();
+	};
+
+
+	auto Context::tokenizeBatch(std::vector<BatchSource>&& sources) noexcept -> std::vector<BatchResult> {
+		evo::debugAssert(
+			this->isSingleThreaded() || this->threadsRunning(),
+			"Context is set to be multi-threaded, but threads are not running"
+		);
+		evo::debugAssert(this->task_group_running == false, "Task group already running");
+
+		this->task_group_running = true;
+
+		auto results = std::vector<BatchResult>();
+		results.reserve(sources.size());
+
+		for(BatchSource& batch_source : sources){
+			this->with_profile_buffer([&](ProfileBuffer& profile_buffer) noexcept -> void {
+				profile_buffer.counters.bytesLoaded += batch_source.data.size();
+			});
+
+			const Source::ID source_id =
+				this->src_manager.addSource(std::move(batch_source.name), std::move(batch_source.data));
+
+			results.emplace_back(source_id, false);
+			this->add_task(TokenizeFileTask(source_id, TaskPhase::Tokenize));
+		}
+
+		if(this->isSingleThreaded()){
+			this->consume_tasks_single_threaded();
+		}else{
+			this->waitForAllTasks();
+		}
+
+		for(BatchResult& result : results){
+			result.tokenized = this->src_manager.getSource(result.sourceID).isTokenized();
+		}
+
+		return results;
+	};
+
+
+	auto Context::getProfileData() const noexcept -> ProfileData {
+		evo::debugAssert(
+			this->task_group_running == false, "Cannot get the profile data while a task group is running"
+		);
+
+		auto profile_data = ProfileData();
+		profile_data.endTime = this->get_profile_time();
+
+		if(this->is_collecting_profile_data() == false){ return profile_data; }
+
+		size_t num_events = 0;
+		for(const ProfileBuffer& profile_buffer : this->profile_buffers){
+			num_events += profile_buffer.events.size();
+		}
+		profile_data.events.reserve(num_events);
+
+		for(const ProfileBuffer& profile_buffer : this->profile_buffers){
+			profile_data.events.insert(
+				profile_data.events.end(), profile_buffer.events.begin(), profile_buffer.events.end()
+			);
+			profile_data.threadCounters.emplace_back(profile_buffer.counters);
+			profile_data.totalCounters += profile_buffer.counters;
+		}
+
+		std::ranges::stable_sort(
+			profile_data.events,
+			[](const ProfileData::Event& lhs, const ProfileData::Event& rhs) noexcept -> bool {
+				return lhs.start < rhs.start;
+			}
+		);
+
+		return profile_data;
+	};
+
+
+	auto Context::getMemoryUsage() const noexcept -> MemoryUsage {
+		evo::debugAssert(
+			this->task_group_running == false, "Cannot get the memory usage while a task group is running"
+		);
+
+		return MemoryUsage(this->src_manager.getMemoryUsage(), this->string_interner.getMemoryUsage());
+	};
+
+
+	auto Context::get_profile_time() const noexcept -> uint64_t {
+		return uint64_t(
+			std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now() - this->profile_start_time
+			).count()
+		);
+	};
+
+
+	auto Context::get_current_worker() const noexcept -> const Worker* {
+		if(current_worker != nullptr && current_worker->getContext() == this){ return current_worker; }
+		return nullptr;
+	};
+
+
+	auto Context::get_profile_thread() const noexcept -> uint32_t {
+		const Worker* const worker = this->get_current_worker();
+		if(worker != nullptr){ return uint32_t(worker->getIndex()); }
+
+		return ProfileData::EXTERNAL_THREAD;
+	};
+
+
+	auto Context::with_profile_buffer(auto&& func) noexcept -> void {
+		if(this->is_collecting_profile_data() == false){ return; }
+
+		const uint32_t thread = this->get_profile_thread();
+
+		if(thread != ProfileData::EXTERNAL_THREAD){
+			func(this->profile_buffers[thread]);
+
+		}else{
+			const auto lock_guard = std::lock_guard(this->external_profile_mutex);
+			func(this->profile_buffers.back());
+		}
+	};
+
+
+	auto Context::lock_profiled(std::mutex& mutex, ProfileData::Lock lock) noexcept -> std::unique_lock<std::mutex> {
+		if(this->is_collecting_profile_data() == false){ return std::unique_lock(mutex); }
+
+		auto unique_lock = std::unique_lock(mutex, std::try_to_lock);
+		if(unique_lock.owns_lock()){ return unique_lock; }
+
+		const uint64_t start_time = this->get_profile_time();
+		unique_lock.lock();
+		const uint64_t end_time = this->get_profile_time();
+
+		const uint32_t thread = this->get_profile_thread();
+
+		this->with_profile_buffer([&](ProfileBuffer& profile_buffer) noexcept -> void {
+			ProfileData::LockCounters& lock_counters = profile_buffer.counters.locks[size_t(lock)];
+			lock_counters.numContended += 1;
+			lock_counters.waitTime += end_time - start_time;
+
+			profile_buffer.events.emplace_back(
+				ProfileData::EventKind::LockWait, lock, thread, ProfileData::NO_SOURCE, 0, start_time, end_time
+			);
+		});
+
+		return unique_lock;
+	};
+
+
+
+
+	auto Context::emit_diagnostic_impl(Diagnostic&& diagnostic) noexcept -> void {
+		if(this->config.immediateDiagnostics){
+			const auto lock = this->lock_profiled(this->callback_mutex, ProfileData::Lock::Callback);
+			this->deliver_diagnostic(diagnostic);
+			return;
+		}
+
+		const Worker* const worker = this->get_current_worker();
+		if(worker != nullptr){
+			this->diagnostic_buffers[worker->getIndex()].emplace_back(std::move(diagnostic));
+
+		}else{
+			const auto lock_guard = std::lock_guard(this->external_diagnostic_buffer_mutex);
+			this->diagnostic_buffers.back().emplace_back(std::move(diagnostic));
+		}
+	};
+
+
+	auto Context::flush_diagnostics() noexcept -> void {
+		if(this->config.immediateDiagnostics){ return; }
+
+		const auto lock = this->lock_profiled(this->callback_mutex, ProfileData::Lock::Callback);
+
+		auto diagnostics = std::vector<Diagnostic>();
+
+		{
+			const auto lock_guard = std::lock_guard(this->external_diagnostic_buffer_mutex);
+
+			for(std::vector<Diagnostic>& diagnostic_buffer : this->diagnostic_buffers){
+				std::ranges::move(diagnostic_buffer, std::back_inserter(diagnostics));
+				diagnostic_buffer.clear();
+			}
+		}
+
+		if(diagnostics.empty()){ return; }
+
+		// Sorted so the output is the same no matter which worker emitted each diagnostic (or in what order).
+		// 		Sources are compared by their location instead of ID as IDs are given in the order the sources
+		// 		finished loading. The code and message are compared last, so even diagnostics at the same
+		// 		location (or with no location) get a consistent order.
+		auto source_locations = std::unordered_map<uint32_t, std::string>();
+		for(const Diagnostic& diagnostic : diagnostics){
+			if(diagnostic.location.has_value() == false){ continue; }
+
+			const Source::ID source_id = diagnostic.location->sourceID;
+			if(source_locations.contains(source_id.get())){ continue; }
+
+			source_locations.emplace(source_id.get(), this->src_manager.getSource(source_id).getLocationAsString());
+		}
+
+		const auto get_sort_key = [&](const Diagnostic& diagnostic) noexcept {
+			if(diagnostic.location.has_value() == false){
+				return std::make_tuple(
+					false,
+					std::string_view(),
+					uint32_t(0), uint32_t(0), uint32_t(0), uint32_t(0),
+					diagnostic.code,
+					std::string_view(diagnostic.message)
+				);
+			}
+
+			const Source::Location& location = *diagnostic.location;
+			return std::make_tuple(
+				true,
+				std::string_view(source_locations.at(location.sourceID.get())),
+				location.lineStart,
+				location.collumnStart,
+				location.lineEnd,
+				location.collumnEnd,
+				diagnostic.code,
+				std::string_view(diagnostic.message)
+			);
+		};
+
+		std::ranges::stable_sort(diagnostics, [&](const Diagnostic& lhs, const Diagnostic& rhs) noexcept -> bool {
+			return get_sort_key(lhs) < get_sort_key(rhs);
+		});
+
+		for(const Diagnostic& diagnostic : diagnostics){
+			this->deliver_diagnostic(diagnostic);
+		}
+	};
+
+
+	auto Context::deliver_diagnostic(const Diagnostic& diagnostic) noexcept -> void {
+		if(this->is_collecting_profile_data() == false){
+			this->callback(*this, diagnostic);
+			return;
+		}
+
+		const uint64_t start_time = this->get_profile_time();
+		this->callback(*this, diagnostic);
+		const uint64_t end_time = this->get_profile_time();
+
+		this->with_profile_buffer([&](ProfileBuffer& profile_buffer) noexcept -> void {
+			profile_buffer.counters.numDiagnostics += 1;
+			profile_buffer.counters.diagnosticCallbackTime += end_time - start_time;
+			profile_buffer.events.emplace_back(
+				ProfileData::EventKind::DiagnosticCallback,
+				ProfileData::Lock(),
+				this->get_profile_thread(),
+				ProfileData::NO_SOURCE,
+				0,
+				start_time,
+				end_time
+			);
+		});
+	};
+
+
+	auto Context::notify_task_errored() noexcept -> void {
+		if(this->num_errors < this->config.maxNumErrors){ return; }
+
+		this->hit_fail_condition = true;
+		this->task_group_stop_source.request_stop();
+	};
+
+
+	auto Context::consume_tasks_single_threaded() noexcept -> void {
+		evo::debugAssert(this->isSingleThreaded(), "Context is not set to be single threaded");
+
+		auto worker = Worker(this, 0);
+
+		// so anything done by the tasks is recorded as being done by the worker
+		Worker* const previous_worker = std::exchange(current_worker, &worker);
+
+		// cancelled tasks are still taken from the queue (and dropped) so they aren't left for the next task group
+		while(this->single_threaded_tasks.empty() == false){
+			worker.get_task_single_threaded();
+		};
+
+		current_worker = previous_worker;
+
+		this->flush_diagnostics();
+		this->release_pending_source_data();
+
+		this->task_group_running = false;
+	};
+
+
+	auto Context::add_task(Task&& task) noexcept -> void {
+		auto queued_task = QueuedTask(
+			std::move(task),
+			this->task_group_stop_source.get_token(),
+			this->is_collecting_profile_data() ? this->get_profile_time() : 0
+		);
+
+		if(this->isSingleThreaded()){
+			this->single_threaded_tasks.emplace(std::move(queued_task));
+			return;
+		}
+
+		this->num_unfinished_tasks += 1;
+
+		if(current_worker != nullptr && current_worker->getContext() == this){
+			current_worker->getTaskDeque().push(std::move(queued_task));
+
+		}else{
+			const size_t worker_index = this->next_worker_to_submit_to.fetch_add(1) % this->workers.size();
+			this->workers[worker_index].getTaskDeque().push(std::move(queued_task));
+		}
+
+		// must be incremented after the push so that a woken worker is guaranteed to find the task
+		this->num_queued_tasks += 1;
+
+		// Idle workers register themselves (under `idle_mutex`) before checking `num_queued_tasks`, so if none are
+		// 		registered yet, any that are about to park will see the new task instead of sleeping through it
+		if(this->num_idle_workers != 0){
+			const auto lock_guard = std::lock_guard(this->idle_mutex);
+			this->work_available_cv.notify_one();
+		}
+	};
+
+
+	auto Context::add_next_phase_task(Source::ID source_id, TaskPhase completed_phase, TaskPhase last_phase) noexcept
+	-> void {
+		if(completed_phase == TaskPhase::Tokenize){
+			this->src_manager.getSource(source_id).is_tokenized = true;
+
+			if(this->config.sourceTokenizedCallback){ this->config.sourceTokenizedCallback(*this, source_id); }
+		}
+
+		if(completed_phase == last_phase){
+			// nothing after the last phase needs the data of the source
+			if(completed_phase == TaskPhase::Tokenize && this->config.releaseSourceData){
+				this->prepare_source_data_release(source_id);
+			}
+			return;
+		}
+
+		switch(completed_phase){
+			break; case TaskPhase::Load: this->add_task(TokenizeFileTask(source_id, last_phase));
+			break; case TaskPhase::Tokenize: evo::debugFatalBreak("No phase after tokenize");
+		};
+	};
+
+
+	auto Context::add_load_file_tasks(evo::ArrayProxy<fs::path> file_paths, TaskPhase last_phase) noexcept -> void {
+		evo::debugAssert(
+			this->isSingleThreaded() || this->threadsRunning(),
+			"Context is set to be multi-threaded, but threads are not running"
+		);
+
+		evo::debugAssert(this->task_group_running == false, "Task group already running");
+
+
+		this->task_group_running = true;
+
+		// so the workers loading the files don't have to allocate the segments
+		this->getSourceManager().reserveSources(this->getSourceManager().numSources() + file_paths.size());
+
+		for(const fs::path& file_path : file_paths){
+			this->add_task(LoadFileTask(file_path, last_phase));
+		}
+
+		if(this->isSingleThreaded()){
+			this->consume_tasks_single_threaded();
+		}
+	};
+
+
+	auto Context::add_discover_files_tasks(
+		evo::ArrayProxy<fs::path> patterns, TaskPhase last_phase, bool only_new_files
+	) noexcept -> void {
+		evo::debugAssert(
+			this->isSingleThreaded() || this->threadsRunning(),
+			"Context is set to be multi-threaded, but threads are not running"
+		);
+
+		evo::debugAssert(this->task_group_running == false, "Task group already running");
+
+
+		this->task_group_running = true;
+
+		auto discovery = std::make_shared<FileDiscoveryState>(last_phase, only_new_files);
+
+		for(const fs::path& pattern : patterns){
+			glob::Pattern parsed_pattern = glob::parse(pattern);
+
+			if(parsed_pattern.components.empty()){
+				auto ec = std::error_code();
+				if(fs::is_directory(parsed_pattern.base, ec) == false){
+					// if it doesn't exist, loading it emits the error
+					this->add_discovered_file(*discovery, std::move(parsed_pattern.base));
+					continue;
+				}
+
+				parsed_pattern.components = {"**", std::format("*{}", SOURCE_FILE_EXTENSION)};
+			}
+
+			auto search = std::make_shared<FileSearch>(
+				discovery, pattern, std::move(parsed_pattern.base), std::move(parsed_pattern.components)
+			);
+
+			this->add_task(DiscoverFilesTask(std::move(search), std::vector<std::string>()));
+		}
+
+		if(this->isSingleThreaded()){
+			this->consume_tasks_single_threaded();
+		}
+	};
+
+
+	// the key of a file in `Context::discovered_files`
+	EVO_NODISCARD static auto get_discovered_file_key(const fs::path& path) noexcept -> std::string {
+		auto ec = std::error_code();
+		fs::path canonical_path = fs::canonical(path, ec);
+		if(ec){ canonical_path = fs::absolute(path, ec).lexically_normal(); } // doesn't exist (or was just removed)
+
+		return canonical_path.string();
+	};
+
+
+	auto Context::add_discovered_file(FileDiscoveryState& discovery, fs::path&& path) noexcept -> void {
+		if(discovery.onlyNewFiles){
+			auto ec = std::error_code();
+			if(fs::exists(path, ec) == false){ return; }
+		}
+
+		std::string key = get_discovered_file_key(path);
+
+		{
+			const auto lock = this->lock_profiled(this->discovered_files_mutex, ProfileData::Lock::FileDiscovery);
+			if(this->discovered_files.emplace(std::move(key)).second == false){ return; }
+		}
+
+		this->add_task(LoadFileTask(std::move(path), discovery.lastPhase));
+	};
+
+
+	//////////////////////////////////////////////////////////////////////
+	// TaskDeque
+
+	auto Context::TaskDeque::push(QueuedTask&& task) noexcept -> void {
+		const auto lock = this->context->lock_profiled(this->mutex, ProfileData::Lock::TaskDeque);
+		this->tasks.emplace_back(std::move(task));
+	};
+
+	auto Context::TaskDeque::pop() noexcept -> std::optional<QueuedTask> {
+		const auto lock = this->context->lock_profiled(this->mutex, ProfileData::Lock::TaskDeque);
+		if(this->tasks.empty()){ return std::nullopt; }
+
+		auto task = std::optional<QueuedTask>(std::move(this->tasks.back()));
+		this->tasks.pop_back();
+		return task;
+	};
+
+	auto Context::TaskDeque::steal() noexcept -> std::optional<QueuedTask> {
+		const auto lock = this->context->lock_profiled(this->mutex, ProfileData::Lock::TaskDeque);
+		if(this->tasks.empty()){ return std::nullopt; }
+
+		auto task = std::optional<QueuedTask>(std::move(this->tasks.front()));
+		this->tasks.pop_front();
+		return task;
+	};
+
+
+	//////////////////////////////////////////////////////////////////////
+	// Worker
+
+
+	auto Context::Worker::get_task(const std::stop_token& stop_token) noexcept -> void {
+		evo::debugAssert(this->context->isMultiThreaded(), "Context is not set to be multi-threaded");
+
+		std::optional<QueuedTask> task = this->task_deque.pop();
+		if(task.has_value() == false){
+			task = this->steal_task();
+		}
+
+		if(task.has_value() == false){
+			this->wait_for_task(stop_token);
+
+		}else{
+			this->context->num_queued_tasks -= 1;
+
+			// tasks of a cancelled task group are dropped, but still count as finished
+			if(task->stopToken.stop_requested() == false){
+				this->run_task(*task);
+			}
+
+			if(this->context->num_unfinished_tasks.fetch_sub(1) == 1){
+				this->context->num_unfinished_tasks.notify_all();
+			}
+		}
+	};
+
+
+	auto Context::Worker::get_task_single_threaded() noexcept -> void {
+		evo::debugAssert(this->context->isSingleThreaded(), "Context is not set to be single-threaded");
+
+		if(this->context->single_threaded_tasks.empty() == false){
+			const QueuedTask task = std::move(this->context->single_threaded_tasks.front());
+			this->context->single_threaded_tasks.pop();
+
+			if(task.stopToken.stop_requested() == false){
+				this->run_task(task);
+			}
+		}
+	};
+
+
+	auto Context::Worker::steal_task() noexcept -> std::optional<QueuedTask> {
+		std::vector<Worker>& workers = this->context->workers;
+
+		for(size_t i = 1; i < workers.size(); i+=1){
+			Worker& victim = workers[(this->index + i) % workers.size()];
+
+			std::optional<QueuedTask> task = victim.task_deque.steal();
+			if(task.has_value()){ return task; }
+		}
+
+		return std::nullopt;
+	};
+
+
+	auto Context::Worker::wait_for_task(const std::stop_token& stop_token) noexcept -> void {
+		const uint64_t start_time = this->context->is_collecting_profile_data() ? this->context->get_profile_time() : 0;
+
+		{
+			auto lock = std::unique_lock(this->context->idle_mutex);
+
+			this->context->num_idle_workers += 1;
+			this->context->work_available_cv.wait(lock, stop_token, [&]() noexcept -> bool {
+				return this->context->num_queued_tasks != 0;
+			});
+			this->context->num_idle_workers -= 1;
+		}
+
+		if(this->context->is_collecting_profile_data()){
+			this->context->profile_buffers[this->index].counters.idleTime +=
+				this->context->get_profile_time() - start_time;
+		}
+	};
+
+
+	auto Context::Worker::run_task(const QueuedTask& queued_task) noexcept -> void {
+		const uint64_t start_time = this->context->is_collecting_profile_data() ? this->context->get_profile_time() : 0;
+
+		const bool run_task_res = queued_task.task.visit([&](auto& value) noexcept -> bool {
+			using ValueT = std::decay_t<decltype(value)>;
+
+			// the long-running tasks are given the stop token so they stop early if the task group is cancelled
+			const std::stop_token& stop_token = queued_task.stopToken;
+
+			     if constexpr(std::is_same_v<ValueT, LoadFileTask>){ return this->run_load_file(value); }
+			else if constexpr(std::is_same_v<ValueT, TokenizeFileTask>){
+				return this->run_tokenize_file(value, stop_token);
+			}
+			else if constexpr(std::is_same_v<ValueT, TokenizeChunkTask>){
+				return this->run_tokenize_chunk(value, stop_token);
+			}
+			else if constexpr(std::is_same_v<ValueT, ReloadFileTask>){
+				return this->context->reload_source_file_impl(value.source_id, stop_token);
+			}
+			else if constexpr(std::is_same_v<ValueT, DiscoverFilesTask>){
+				return this->run_discover_files(value, stop_token);
+			}
+		});
+
+		if(this->context->is_collecting_profile_data()){
+			this->record_task_profile(queued_task, start_time);
+		}
+
+		if(run_task_res == false){
+			this->context->notify_task_errored();
+		}	
+	};
+
+
+	auto Context::Worker::record_task_profile(const QueuedTask& queued_task, uint64_t start_time) noexcept -> void {
+		const uint64_t end_time = this->context->get_profile_time();
+
+		ProfileBuffer& profile_buffer = this->context->profile_buffers[this->index];
+
+		profile_buffer.counters.numTasks += 1;
+		profile_buffer.counters.taskTime += end_time - start_time;
+		profile_buffer.counters.queueWaitTime += start_time - queued_task.queuedTime;
+
+		auto event = ProfileData::Event(
+			ProfileData::EventKind::LoadFile,
+			ProfileData::Lock(),
+			uint32_t(this->index),
+			ProfileData::NO_SOURCE,
+			0,
+			start_time,
+			end_time
+		);
+
+		queued_task.task.visit([&](auto& value) noexcept -> void {
+			using ValueT = std::decay_t<decltype(value)>;
+
+			if constexpr(std::is_same_v<ValueT, LoadFileTask>){
+				event.kind = ProfileData::EventKind::LoadFile;
+				event.sourceID = std::exchange(this->loaded_source_id, ProfileData::NO_SOURCE);
+
+			}else if constexpr(std::is_same_v<ValueT, TokenizeFileTask>){
+				event.kind = ProfileData::EventKind::TokenizeFile;
+				event.sourceID = value.source_id.get();
+
+			}else if constexpr(std::is_same_v<ValueT, TokenizeChunkTask>){
+				event.kind = ProfileData::EventKind::TokenizeChunk;
+				event.sourceID = value.state->source_id.get();
+				event.chunkIndex = uint32_t(value.chunk_index);
+
+			}else if constexpr(std::is_same_v<ValueT, ReloadFileTask>){
+				event.kind = ProfileData::EventKind::ReloadFile;
+				event.sourceID = value.source_id.get();
+
+			}else if constexpr(std::is_same_v<ValueT, DiscoverFilesTask>){
+				event.kind = ProfileData::EventKind::DiscoverFiles;
+			}
+		});
+
+		profile_buffer.events.emplace_back(event);
+	};
+
+
+
+	auto Context::Worker::run_load_file(const LoadFileTask& task) noexcept -> bool {
+		// so the file is loaded again if a discovery finds it again
+		const auto forget_discovered_file = [&]() noexcept -> void {
+			std::string key = get_discovered_file_key(task.path);
+
+			const auto lock = this->context->lock_profiled(
+				this->context->discovered_files_mutex, ProfileData::Lock::FileDiscovery
+			);
+			this->context->discovered_files.erase(key);
+		};
+
+		if(evo::fs::exists(task.path.string()) == false){
+			forget_discovered_file();
+
+			this->context->num_errors += 1;
+			this->context->emit_diagnostic_internal(
+				Diagnostic::Level::Error, Diagnostic::Code::MiscFileDoesNotExist, std::nullopt,
+				std::format("File \"{}\" does not exist", task.path.string())
+			);
+			return false;
+		}
+
+		const std::optional<Source::ID> source_id = [&]() noexcept -> std::optional<Source::ID> {
+			if(this->context->config.memoryMapFiles){
+				return this->map_file(task);
+			}else{
+				return this->read_file(task);
+			}
+		}();
+
+		if(source_id.has_value() == false){
+			forget_discovered_file();
+
+			this->context->num_errors += 1;
+			this->context->emit_diagnostic_internal(
+				Diagnostic::Level::Error, Diagnostic::Code::MiscLoadFileFailed, std::nullopt,
+				std::format("Failed to load file: \"{}\"", task.path.string())
+			);
+			return false;
+		}
+
+		this->loaded_source_id = source_id->get();
+
+		this->context->emitTrace("Loaded file: \"{}\"", task.path.string());
+
+		this->context->add_next_phase_task(*source_id, TaskPhase::Load, task.lastPhase);
+		return true;
+	};
+
+
+	auto Context::Worker::read_file(const LoadFileTask& task) noexcept -> std::optional<Source::ID> {
+		std::optional<std::string> data = read_file_data(task.path);
+		if(data.has_value() == false){ return std::nullopt; }
+
+		this->context->with_profile_buffer([&](ProfileBuffer& profile_buffer) noexcept -> void {
+			profile_buffer.counters.bytesLoaded += data->size();
+		});
+
+		return this->context->getSourceManager().addSource(task.path, std::move(*data));
+	};
+
+
+	auto Context::Worker::map_file(const LoadFileTask& task) noexcept -> std::optional<Source::ID> {
+		auto mapped_file = core::MappedFile();
+		if(mapped_file.open(task.path) == false){ return std::nullopt; }
+
+		this->context->with_profile_buffer([&](ProfileBuffer& profile_buffer) noexcept -> void {
+			profile_buffer.counters.bytesLoaded += mapped_file.size();
+		});
+
+		return this->context->getSourceManager().addSource(task.path, std::move(mapped_file));
+	};
+
+
+
+	auto Context::Worker::run_discover_files(const DiscoverFilesTask& task, const std::stop_token& stop_token)
+	noexcept -> bool {
+		FileSearch& search = *task.search;
+
+		fs::path directory_path = search.base;
+		for(const std::string& component : task.directoryComponents){
+			directory_path /= component;
+		}
+
+		// the last directory of the search to finish warns if nothing matched
+		// 	(unless searching failed, as that already emitted an error)
+		const auto finish = [&]() noexcept -> void {
+			if(search.numDirectoriesLeft.fetch_sub(1) != 1 || search.foundAnyFiles || search.failed){ return; }
+			if(search.discovery->onlyNewFiles){ return; } // already warned about when first searched
+
+			this->context->emit_diagnostic_internal(
+				Diagnostic::Level::Warning, Diagnostic::Code::MiscNoFilesMatched, std::nullopt,
+				std::format("No files matched \"{}\"", search.pattern.string())
+			);
+		};
+
+		// (searching again for new files doesn't report anything, as the patterns were searched before)
+		const auto fail = [&](std::string&& message) noexcept -> bool {
+			if(search.discovery->onlyNewFiles == false){
+				this->context->num_errors += 1;
+				this->context->emit_diagnostic_internal(
+					Diagnostic::Level::Error,
+					task.directoryComponents.empty() && evo::fs::exists(directory_path.string()) == false
+						? Diagnostic::Code::MiscFileDoesNotExist
+						: Diagnostic::Code::MiscLoadFileFailed,
+					std::nullopt,
+					std::move(message)
+				);
+			}
+			search.failed = true;
+			finish();
+			return search.discovery->onlyNewFiles;
+		};
+
+		// the task group was cancelled (by whatever errored, so nothing is reported)
+		const auto cancel = [&]() noexcept -> bool {
+			search.failed = true;
+			finish();
+			return true;
+		};
+
+		if(stop_token.stop_requested()){ return cancel(); }
+
+
+		// a pattern that starts with a wildcard searches the current directory
+		const fs::path& search_path = directory_path.empty() ? fs::path(".") : directory_path;
+		auto ec = std::error_code();
+
+		const fs::path canonical_path = fs::canonical(search_path, ec);
+		if(ec){ return fail(std::format("Directory \"{}\" does not exist", search_path.string())); }
+
+		{
+			const auto lock = this->context->lock_profiled(search.discovery->mutex, ProfileData::Lock::FileDiscovery);
+			if(search.searchedDirectories.emplace(canonical_path.string()).second == false){
+				finish();
+				return true;
+			}
+		}
+
+		auto directory_iterator = fs::directory_iterator(
+			search_path, fs::directory_options::skip_permission_denied, ec
+		);
+		if(ec){ return fail(std::format("Failed to read directory: \"{}\"", search_path.string())); }
+
+		auto subdirectories = std::vector<std::vector<std::string>>();
+		auto files = std::vector<fs::path>();
+
+		auto entry_components = task.directoryComponents;
+		entry_components.emplace_back();
+
+		for(; directory_iterator != fs::directory_iterator(); directory_iterator.increment(ec)){
+			if(ec){ return fail(std::format("Failed to read directory: \"{}\"", search_path.string())); }
+			if(stop_token.stop_requested()){ return cancel(); }
+
+			const fs::directory_entry& entry = *directory_iterator;
+			entry_components.back() = entry.path().filename().string();
+
+			if(entry.is_directory(ec)){
+				if(glob::couldMatchInside(search.patternComponents, entry_components)){
+					subdirectories.emplace_back(entry_components);
+				}
+
+			}else if(entry.is_regular_file(ec)){
+				if(glob::match(search.patternComponents, entry_components)){
+					files.emplace_back(directory_path / entry_components.back());
+				}
+			}
+		}
+		if(ec){ return fail(std::format("Failed to read directory: \"{}\"", search_path.string())); }
+
+
+		// Subdirectories are added first, so this worker loads the files next (it takes its newest tasks first)
+		// 		while idle workers steal the subdirectories (they take the oldest tasks first)
+		search.numDirectoriesLeft += subdirectories.size();
+		for(std::vector<std::string>& subdirectory : subdirectories){
+			this->context->add_task(DiscoverFilesTask(task.search, std::move(subdirectory)));
+		}
+
+		if(files.empty() == false){
+			search.foundAnyFiles = true;
+
+			for(fs::path& file : files){
+				this->context->add_discovered_file(*search.discovery, std::move(file));
+			}
+		}
+
+		this->context->emitTrace(
+			"Searched directory: \"{}\" ({} files matched)", search_path.string(), files.size()
+		);
+
+		finish();
+		return true;
+	};
+
+
+	auto Context::Worker::run_tokenize_file(const TokenizeFileTask& task, const std::stop_token& stop_token)
+	noexcept -> bool {
+		const SourceManager& source_manager = this->context->getSourceManager();
+		const Source& source = source_manager.getSource(task.source_id);
+
+		// the data of sources is validated when they're added, but only reported when they would be tokenized
+		if(this->context->check_source_is_valid_utf8(source) == false){ return false; }
+
+		auto token_cache_key = std::optional<uint64_t>();
+		if(this->context->config.tokenCacheDirectory.empty() == false){
+			token_cache_key = TokenCache::getKey(source);
+
+			auto token_cache = TokenCache(*this->context, this->context->config.tokenCacheDirectory);
+			std::optional<TokenBuffer> cached_token_buffer = token_cache.load(source, *token_cache_key);
+
+			if(cached_token_buffer.has_value()){
+				// only balanced tokens are saved, but the check is cheap (and the cache could've been changed)
+				if(this->context->check_brackets_are_balanced(source, *cached_token_buffer) == false){ return false; }
+
+				std::construct_at(&source.token_buffer, std::move(*cached_token_buffer));
+				this->add_tokens_produced(source.getTokenBuffer().size());
+
+				this->context->emitTrace("Loaded tokens of file from cache: \"{}\"", source.getLocationAsString());
+
+				this->context->add_next_phase_task(task.source_id, TaskPhase::Tokenize, task.lastPhase);
+				return true;
+			}
+		}
+
+		const size_t parallel_tokenize_threshold = this->context->config.parallelTokenizeThreshold;
+		if(
+			this->context->isMultiThreaded()
+			&& parallel_tokenize_threshold != 0
+			&& source.getData().size() >= parallel_tokenize_threshold
+		){
+			this->add_tokenize_chunk_tasks(task, token_cache_key);
+			return true;
+		}
+
+		auto tokenizer = Tokenizer(*this->context, task.source_id, stop_token);
+
+		evo::Result<TokenBuffer> result = tokenizer.tokenize();
+		if(result.isError()){ return false; }
+
+		// brackets can only be matched once all of the tokens are known (so not while tokenizing chunks)
+		if(this->context->check_brackets_are_balanced(source, result.value()) == false){ return false; }
+
+		std::construct_at(&source.token_buffer, std::move(result.value()));
+		this->add_tokens_produced(source.getTokenBuffer().size());
+
+		#if defined(PCIT_BUILD_DEBUG)
+			evo::debugAssert(
+				matches_token_stream(*this->context, source),
+				"Streaming the tokens gave different tokens than a full tokenize"
+			);
+		#endif
+
+		this->context->emitTrace("Tokenized file: \"{}\"", source.getLocationAsString());
+
+		this->save_to_token_cache(source, token_cache_key);
+
+		this->context->add_next_phase_task(task.source_id, TaskPhase::Tokenize, task.lastPhase);
+		return true;
+	};
+
+
+	auto Context::Worker::add_tokenize_chunk_tasks(
+		const TokenizeFileTask& task, std::optional<uint64_t> token_cache_key
+	) noexcept -> void {
+		const Source& source = this->context->getSourceManager().getSource(task.source_id);
+
+		auto state = std::make_shared<TokenizeChunksState>(
+			task.source_id,
+			task.lastPhase,
+			Tokenizer::findChunkStarts(source.getData(), this->context->config.parallelTokenizeChunkSize),
+			std::vector<TokenBuffer>(),
+			token_cache_key
+		);
+
+		const size_t num_chunks = state->chunkStarts.size();
+		state->chunkTokenBuffers.resize(num_chunks);
+		state->numChunksLeft = num_chunks;
+
+		this->context->emitTrace(
+			"Tokenizing file in {} chunks: \"{}\"", num_chunks, source.getLocationAsString()
+		);
+
+		for(size_t i = 0; i < num_chunks; i+=1){
+			this->context->add_task(TokenizeChunkTask(state, i));
+		}
+	};
+
+
+	auto Context::Worker::run_tokenize_chunk(const TokenizeChunkTask& task, const std::stop_token& stop_token)
+	noexcept -> bool {
+		TokenizeChunksState& state = *task.state;
+		const Source& source = this->context->getSourceManager().getSource(state.source_id);
+
+		const uint32_t chunk_start = state.chunkStarts[task.chunk_index];
+		const uint32_t chunk_end = task.chunk_index + 1 < state.chunkStarts.size()
+			? state.chunkStarts[task.chunk_index + 1]
+			: uint32_t(source.getData().size());
+
+		auto tokenizer = Tokenizer(*this->context, state.source_id, chunk_start, chunk_end, stop_token);
+		evo::Result<TokenBuffer> result = tokenizer.tokenize();
+
+		const bool chunk_errored = result.isError();
+		if(chunk_errored){
+			state.errored = true;
+		}else{
+			// each chunk only writes to its own buffer (the last chunk reads them after `numChunksLeft` hits 0)
+			state.chunkTokenBuffers[task.chunk_index] = std::move(result.value());
+		}
+
+		if(state.numChunksLeft.fetch_sub(1) != 1){ return chunk_errored == false; }
+
+
+		///////////////////////////////////
+		// last chunk to finish, so join the chunks
+
+		if(state.errored){ return chunk_errored == false; }
+
+		auto token_buffer = std::move(state.chunkTokenBuffers[0]);
+		for(size_t i = 1; i < state.chunkTokenBuffers.size(); i+=1){
+			token_buffer.append(state.chunkTokenBuffers[i]);
+		}
+		state.chunkTokenBuffers.clear();
+
+		if(this->context->check_brackets_are_balanced(source, token_buffer) == false){ return false; }
+
+		std::construct_at(&source.token_buffer, std::move(token_buffer));
+		this->add_tokens_produced(source.getTokenBuffer().size());
+
+		#if defined(PCIT_BUILD_DEBUG)
+			evo::debugAssert(
+				matches_full_tokenize(*this->context, source),
+				"Joining the chunks gave different tokens than a full tokenize"
+			);
+		#endif
+
+		this->context->emitTrace("Tokenized file: \"{}\"", source.getLocationAsString());
+
+		this->save_to_token_cache(source, state.tokenCacheKey);
+
+		this->context->add_next_phase_task(state.source_id, TaskPhase::Tokenize, state.lastPhase);
+		return true;
+	};
+
+
+	auto Context::Worker::save_to_token_cache(const Source& source, std::optional<uint64_t> token_cache_key) noexcept
+	-> void {
+		if(token_cache_key.has_value() == false){ return; }
+
+		auto token_cache = TokenCache(*this->context, this->context->config.tokenCacheDirectory);
+		token_cache.save(source, *token_cache_key, source.getTokenBuffer());
+
+		this->context->emitTrace("Saved tokens of file to cache: \"{}\"", source.getLocationAsString());
+	};
+
+
+	auto Context::Worker::add_tokens_produced(size_t num_tokens) noexcept -> void {
+		if(this->context->is_collecting_profile_data() == false){ return; }
+
+		this->context->profile_buffers[this->index].counters.tokensProduced += num_tokens;
 	};
 
 
@@ -9,9 +9,236 @@
 
 #include "../include/Source.h"
 
+#include <ranges>
+
+#include "./char_scanning.h"
+
 namespace pcit::panther{
 	
 
+	auto Source::getData() const noexcept -> std::string_view {
+		if(this->data.is<std::string>()){
+			return std::string_view(this->data.as<std::string>()).substr(this->data_start);
+		}else{
+			return this->data.as<core::MappedFile>().getData().substr(this->data_start);
+		}
+	};
+
+	auto Source::isMemoryMapped() const noexcept -> bool {
+		return this->data.is<core::MappedFile>();
+	};
+
+
+	auto Source::getMemoryUsage() const noexcept -> MemoryUsage {
+		auto memory_usage = MemoryUsage();
+
+		if(this->data.is<std::string>()){
+			memory_usage.ownedData = this->data.as<std::string>().capacity();
+		}else{
+			memory_usage.mappedData = this->data.as<core::MappedFile>().size();
+		}
+
+		memory_usage.lineStarts = this->line_starts.capacity() * sizeof(uint32_t);
+		memory_usage.tokens = this->token_buffer.getMemoryUsage();
+
+		return memory_usage;
+	};
+
+
+	auto Source::getLineAndCollumn(uint32_t offset) const noexcept -> LineAndCollumn {
+		evo::debugAssert(
+			offset <= (this->is_data_released ? this->released_data_size : this->getData().size()),
+			"Offset is not in the source"
+		);
+
+		const auto line_iter = std::ranges::upper_bound(this->line_starts, offset) - 1;
+
+		return LineAndCollumn(
+			uint32_t(std::distance(this->line_starts.begin(), line_iter)) + 1, offset - *line_iter + 1
+		);
+	};
+
+	auto Source::getLineStartOffset(uint32_t line) const noexcept -> uint32_t {
+		evo::debugAssert(line != 0 && line <= this->line_starts.size(), "Line is not in the source");
+
+		return this->line_starts[line - 1];
+	};
+
+
+	auto Source::getLocation(uint32_t start_offset, uint32_t end_offset) const noexcept -> Location {
+		const LineAndCollumn start = this->getLineAndCollumn(start_offset);
+		const LineAndCollumn end = this->getLineAndCollumn(end_offset);
+
+		return Location(this->id, start.line, end.line, start.collumn, end.collumn);
+	};
+
+	auto Source::getLocation(uint32_t offset) const noexcept -> Location {
+		const LineAndCollumn line_and_collumn = this->getLineAndCollumn(offset);
+
+		return Location(this->id, line_and_collumn.line, line_and_collumn.collumn);
+	};
+
+
+	auto Source::init_data() noexcept -> void {
+		this->data_start = 0;
+		if(this->getData().starts_with(UTF8_BYTE_ORDER_MARK)){
+			this->data_start = uint32_t(UTF8_BYTE_ORDER_MARK.size());
+		}
+
+		this->validate_utf8();
+		this->build_line_starts();
+	};
+
+
+	auto Source::validate_utf8() noexcept -> void {
+		const std::string_view source_data = this->getData();
+
+		// most sources are all ASCII, which is checked first as it's faster than validating
+		const size_t first_non_ascii = char_scanning::findFirstNonASCII(source_data);
+		this->is_ascii = first_non_ascii == source_data.size();
+
+		const size_t invalid_offset = first_non_ascii + char_scanning::findInvalidUTF8(
+			source_data.substr(first_non_ascii)
+		);
+
+		if(invalid_offset == source_data.size()){
+			this->invalid_utf8_offset.reset();
+		}else{
+			this->invalid_utf8_offset = uint32_t(invalid_offset);
+		}
+	};
+
+
+	auto Source::build_line_starts() noexcept -> void {
+		const std::string_view source_data = this->getData();
+
+		evo::debugAssert(
+			source_data.size() <= std::numeric_limits<uint32_t>::max(), "Sources are limited to 4GB (32-bit offsets)"
+		);
+
+		this->line_starts.clear();
+		this->line_starts.reserve(char_scanning::countNewlines(source_data) + 1);
+		this->line_starts.emplace_back(0);
+
+		size_t i = char_scanning::findFirstOf(source_data, '\n', '\r');
+		while(i < source_data.size()){
+			if(source_data[i] == '\r' && i + 1 < source_data.size() && source_data[i + 1] == '\n'){
+				i += 1;
+			}
+
+			i += 1;
+			this->line_starts.emplace_back(uint32_t(i));
+
+			i += char_scanning::findFirstOf(source_data.substr(i), '\n', '\r');
+		}
+	};
+
+
+
+	auto Source::apply_edits(evo::ArrayProxy<Edit> edits) noexcept -> EditedRange {
+		evo::debugAssert(edits.empty() == false, "No edits to apply");
+
+		auto sorted_edits = std::vector<Edit>(edits.begin(), edits.end());
+		std::ranges::sort(sorted_edits, [](const Edit& lhs, const Edit& rhs){ return lhs.offset < rhs.offset; });
+
+
+		///////////////////////////////////
+		// edit data
+
+		const std::string_view old_data = this->getData();
+
+		auto new_data = std::string();
+		{
+			size_t new_data_size = old_data.size();
+			for(const Edit& edit : sorted_edits){
+				new_data_size += edit.insertedText.size();
+				new_data_size -= edit.removedLength;
+			}
+			new_data.reserve(new_data_size);
+		}
+
+		size_t old_data_copied = 0;
+		for(const Edit& edit : sorted_edits){
+			evo::debugAssert(edit.offset >= old_data_copied, "Edits cannot overlap");
+			evo::debugAssert(size_t(edit.offset) + edit.removedLength <= old_data.size(), "Edit is not in the source");
+
+			new_data.append(old_data.substr(old_data_copied, edit.offset - old_data_copied));
+			new_data.append(edit.insertedText);
+			old_data_copied = size_t(edit.offset) + edit.removedLength;
+		}
+		new_data.append(old_data.substr(old_data_copied));
+
+		evo::debugAssert(
+			new_data.size() <= std::numeric_limits<uint32_t>::max(), "Sources are limited to 4GB (32-bit offsets)"
+		);
+
+		const int64_t offset_shift = int64_t(new_data.size()) - int64_t(old_data.size());
+
+		const auto token_indices = std::views::iota(uint32_t(0), uint32_t(this->token_buffer.size()));
+		const uint32_t first_moved_token = *std::ranges::partition_point(token_indices, [&](uint32_t token_index){
+			return this->token_buffer.getLocation(Token::ID(token_index)).offset < old_data_copied;
+		});
+
+		const auto edited_range = EditedRange{
+			.start           = sorted_edits.front().offset,
+			.oldEnd          = uint32_t(old_data_copied),
+			.newEnd          = uint32_t(int64_t(old_data_copied) + offset_shift),
+			.firstMovedToken = first_moved_token,
+		};
+
+
+		std::destroy_at(&this->data);
+		std::construct_at(&this->data, std::move(new_data));
+		this->data_start = 0; // the edited data never has the byte order mark
+
+		// edits can insert anything, so all of the edited data is validated again (it was just copied anyway)
+		this->validate_utf8();
+
+		// `old_data` is no longer valid, but the tokens only need its address to find their views into it
+		this->token_buffer.moveToEditedData(old_data, this->getData(), edited_range.firstMovedToken, offset_shift);
+
+
+		///////////////////////////////////
+		// line starts
+		// 	(a line start depends on the line break before it, so the lines are re-scanned from the last character
+		// 	before the edit until the first line start after it, and the rest are just moved)
+
+		const std::string_view edited_data = this->getData();
+
+		// (the first line always starts at 0)
+		const auto first_removed_line_start = std::ranges::lower_bound(
+			this->line_starts, std::max(edited_range.start, uint32_t(1))
+		);
+		const auto first_moved_line_start = std::ranges::upper_bound(this->line_starts, edited_range.oldEnd);
+
+		for(auto iter = first_moved_line_start; iter != this->line_starts.end(); ++iter){
+			*iter = uint32_t(int64_t(*iter) + offset_shift);
+		}
+
+		auto edited_line_starts = std::vector<uint32_t>();
+
+		size_t i = edited_range.start == 0 ? 0 : edited_range.start - 1;
+		i += char_scanning::findFirstOf(edited_data.substr(i), '\n', '\r');
+		while(i < edited_data.size()){
+			if(edited_data[i] == '\r' && i + 1 < edited_data.size() && edited_data[i + 1] == '\n'){
+				i += 1;
+			}
+
+			i += 1;
+			if(i > edited_range.newEnd){ break; }
+			edited_line_starts.emplace_back(uint32_t(i));
+
+			i += char_scanning::findFirstOf(edited_data.substr(i), '\n', '\r');
+		}
+
+		const auto insert_location = this->line_starts.erase(first_removed_line_start, first_moved_line_start);
+		this->line_starts.insert(insert_location, edited_line_starts.begin(), edited_line_starts.end());
+
+		return edited_range;
+	};
+
+
+
 	auto Source::locationIsPath() const noexcept -> bool {
 		return this->location.is<fs::path>();
 	};
@@ -41,4 +268,34 @@ namespace pcit::panther{
 	};
 
 
-};
\ No newline at end of file
+	auto Source::release_data() noexcept -> void {
+		evo::debugAssert(this->is_data_released == false, "Data of source was already released");
+
+		this->released_data_size = this->getData().size();
+
+		std::destroy_at(&this->data);
+		std::construct_at(&this->data, std::string());
+		this->data_start = 0;
+
+		this->is_data_released = true;
+		this->is_data_release_pending = false;
+	};
+
+
+	auto Source::replace_released_data(std::string&& new_data) noexcept -> void {
+		evo::debugAssert(this->is_data_released, "Data of source was not released");
+
+		std::destroy_at(&this->data);
+		std::construct_at(&this->data, std::move(new_data));
+
+		this->is_data_released = false;
+		this->released_data_size = 0;
+
+		this->init_data();
+
+		this->token_buffer = TokenBuffer();
+		this->is_tokenized = false;
+	};
+
+
+};
@@ -9,74 +9,167 @@
 
 #include "../include/SourceManager.h"
 
+#include <bit>
+#include <memory>
+
 namespace pcit::panther{
 
 
-	auto SourceManager::reserveSources(size_t num_sources) noexcept -> void {
-		this->sources.reserve(num_sources);
+	SourceManager::~SourceManager() noexcept {
+		this->clear();
+
+		for(size_t i = 0; i < MAX_NUM_SEGMENTS; i+=1){
+			Source* const segment = this->segments[i].load();
+			if(segment == nullptr){ continue; }
+
+			std::allocator<Source>().deallocate(segment, get_segment_size(i));
+		}
+	};
+
+
+	auto SourceManager::clear() noexcept -> void {
+		const uint32_t num_sources_added = this->num_sources.load();
+
+		for(uint32_t i = 0; i < num_sources_added; i+=1){
+			const SlotIndex slot_index = get_slot_index(i);
+			std::destroy_at(&this->segments[slot_index.segment].load()[slot_index.index]);
+		}
+
+		this->num_sources = 0;
+	};
+
+
+	auto SourceManager::reserveSources(size_t num_sources_to_reserve) noexcept -> void {
+		if(num_sources_to_reserve == 0){ return; }
+
+		const size_t last_segment = get_slot_index(uint32_t(num_sources_to_reserve - 1)).segment;
+		for(size_t i = 0; i <= last_segment; i+=1){
+			std::ignore = this->get_or_create_segment(i);
+		}
 	};
 
 
-	// TODO: create custom vector impl to not have to do a push_back
-	// 		(can't do a emplace_back because I want Source::Source() to be private)
 	auto SourceManager::addSource(const std::string& location, const std::string& data) noexcept -> Source::ID {
-		const Source::ID new_source_id = Source::ID(uint32_t(this->sources.size()));
-		this->sources.push_back(Source(new_source_id, location, data));
-		return new_source_id;
+		return this->add_source(location, data);
 	};
 
 	auto SourceManager::addSource(const std::string& location, std::string&& data) noexcept -> Source::ID {
-		const Source::ID new_source_id = Source::ID(uint32_t(this->sources.size()));
-		this->sources.push_back(Source(new_source_id, location, std::move(data)));
-		return new_source_id;
+		return this->add_source(location, std::move(data));
 	};
 
 	auto SourceManager::addSource(std::string&& location, const std::string& data) noexcept -> Source::ID {
-		const Source::ID new_source_id = Source::ID(uint32_t(this->sources.size()));
-		this->sources.push_back(Source(new_source_id, std::move(location), data));
-		return new_source_id;
+		return this->add_source(std::move(location), data);
 	};
 
 	auto SourceManager::addSource(std::string&& location, std::string&& data) noexcept -> Source::ID {
-		const Source::ID new_source_id = Source::ID(uint32_t(this->sources.size()));
-		this->sources.push_back(Source(new_source_id, std::move(location), std::move(data)));
-		return new_source_id;
+		return this->add_source(std::move(location), std::move(data));
 	};
 
 
 	auto SourceManager::addSource(const fs::path& location, const std::string& data) noexcept -> Source::ID {
-		const Source::ID new_source_id = Source::ID(uint32_t(this->sources.size()));
-		this->sources.push_back(Source(new_source_id, location, data));
-		return new_source_id;
+		return this->add_source(location, data);
 	};
 
 	auto SourceManager::addSource(const fs::path& location, std::string&& data) noexcept -> Source::ID {
-		const Source::ID new_source_id = Source::ID(uint32_t(this->sources.size()));
-		this->sources.push_back(Source(new_source_id, location, std::move(data)));
-		return new_source_id;
+		return this->add_source(location, std::move(data));
 	};
 
 	auto SourceManager::addSource(fs::path&& location, const std::string& data) noexcept -> Source::ID {
-		const Source::ID new_source_id = Source::ID(uint32_t(this->sources.size()));
-		this->sources.push_back(Source(new_source_id, std::move(location), data));
-		return new_source_id;
+		return this->add_source(std::move(location), data);
 	};
 
 	auto SourceManager::addSource(fs::path&& location, std::string&& data) noexcept -> Source::ID {
-		const Source::ID new_source_id = Source::ID(uint32_t(this->sources.size()));
-		this->sources.push_back(Source(new_source_id, std::move(location), std::move(data)));
-		return new_source_id;
+		return this->add_source(std::move(location), std::move(data));
+	};
+
+
+	auto SourceManager::addSource(const fs::path& location, core::MappedFile&& mapped_file) noexcept -> Source::ID {
+		return this->add_source(location, std::move(mapped_file));
+	};
+
+	auto SourceManager::addSource(fs::path&& location, core::MappedFile&& mapped_file) noexcept -> Source::ID {
+		return this->add_source(std::move(location), std::move(mapped_file));
 	};
 
 
 
 	
 	auto SourceManager::getSource(Source::ID id) noexcept -> Source& {
-		return this->sources[id.get()];
+		const SlotIndex slot_index = get_slot_index(id.get());
+		return this->segments[slot_index.segment].load(std::memory_order_acquire)[slot_index.index];
 	};
 
 	auto SourceManager::getSource(Source::ID id) const noexcept -> const Source& {
-		return this->sources[id.get()];
+		const SlotIndex slot_index = get_slot_index(id.get());
+		return this->segments[slot_index.segment].load(std::memory_order_acquire)[slot_index.index];
+	};
+
+
+
+	auto SourceManager::getMemoryUsage() const noexcept -> MemoryUsage {
+		auto memory_usage = MemoryUsage();
+		memory_usage.sources.reserve(this->numSources());
+
+		for(Source::ID source_id : *this){
+			const Source::MemoryUsage& source_memory_usage =
+				memory_usage.sources.emplace_back(this->getSource(source_id).getMemoryUsage());
+
+			memory_usage.total += source_memory_usage;
+		}
+
+		for(size_t i = 0; i < MAX_NUM_SEGMENTS; i+=1){
+			if(this->segments[i].load() == nullptr){ continue; }
+			memory_usage.storage += get_segment_size(i) * sizeof(Source);
+		}
+
+		return memory_usage;
+	};
+
+
+
+	auto SourceManager::add_source(auto&&... source_args) noexcept -> Source::ID {
+		const uint32_t source_index = this->num_sources.fetch_add(1);
+		evo::debugAssert(source_index != std::numeric_limits<uint32_t>::max(), "Too many sources");
+
+		const SlotIndex slot_index = get_slot_index(source_index);
+		Source* const segment = this->get_or_create_segment(slot_index.segment);
+
+		const auto new_source_id = Source::ID(source_index);
+
+		// placement new instead of `std::construct_at` as the constructor of Source is private
+		::new(static_cast<void*>(&segment[slot_index.index]))
+			Source(new_source_id, std::forward<decltype(source_args)>(source_args)...);
+
+		return new_source_id;
+	};
+
+
+	auto SourceManager::get_slot_index(uint32_t source_index) noexcept -> SlotIndex {
+		// segment `n` starts at index `FIRST_SEGMENT_SIZE * (2^n - 1)`
+		const size_t num_first_segments = size_t(source_index) / FIRST_SEGMENT_SIZE + 1;
+		const size_t segment = size_t(std::bit_width(num_first_segments)) - 1;
+
+		return SlotIndex(segment, size_t(source_index) - FIRST_SEGMENT_SIZE * ((size_t(1) << segment) - 1));
+	};
+
+
+	auto SourceManager::get_or_create_segment(size_t segment) noexcept -> Source* {
+		evo::debugAssert(segment < MAX_NUM_SEGMENTS, "Segment index out of range");
+
+		Source* existing_segment = this->segments[segment].load(std::memory_order_acquire);
+		if(existing_segment != nullptr){ return existing_segment; }
+
+		Source* const new_segment = std::allocator<Source>().allocate(get_segment_size(segment));
+
+		if(this->segments[segment].compare_exchange_strong(
+			existing_segment, new_segment, std::memory_order_acq_rel, std::memory_order_acquire
+		)){
+			return new_segment;
+		}
+
+		// another thread published the segment first
+		std::allocator<Source>().deallocate(new_segment, get_segment_size(segment));
+		return existing_segment;
 	};
 
 };
\ No newline at end of file
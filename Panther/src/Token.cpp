@@ -0,0 +1,22 @@
+//////////////////////////////////////////////////////////////////////
+//                                                                  //
+// Part of the PCIT-CPP, under the Apache License v2.0              //
+// You may not use this file except in compliance with the License. //
+// See `http://www.apache.org/licenses/LICENSE-2.0` for info        //
+//                                                                  //
+//////////////////////////////////////////////////////////////////////
+
+
+#include "../include/Token.h"
+
+#include "../include/Source.h"
+
+namespace pcit::panther{
+	
+
+	auto Token::getSourceLocation(const Source& source) const noexcept -> SourceLocation {
+		return source.getLocation(this->location.offset, this->location.offset + this->location.length);
+	};
+
+
+};
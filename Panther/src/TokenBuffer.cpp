@@ -9,50 +9,548 @@
 
 #include "../include/TokenBuffer.h"
 
+#include <atomic>
+#include <bit>
+#include <mutex>
+
+#include "./literal_decoding.h"
+
 namespace pcit::panther{
 	
 
 	auto TokenBuffer::createToken(Token::Kind kind, Token::Location location) noexcept -> Token::ID {
-		this->tokens.emplace_back(kind, location);
-		return Token::ID(uint32_t(this->tokens.size()));
+		return this->create_token_impl(kind, location);
 	};
 
 
 	auto TokenBuffer::createToken(Token::Kind kind, Token::Location location, bool value) noexcept -> Token::ID {
-		this->tokens.emplace_back(kind, location, value);
-		return Token::ID(uint32_t(this->tokens.size()));
+		return this->create_token_impl(kind, location, Token::Value{.boolean = value});
 	};
 
 	auto TokenBuffer::createToken(Token::Kind kind, Token::Location location, uint64_t value) noexcept -> Token::ID {
-		this->tokens.emplace_back(kind, location, value);
-		return Token::ID(uint32_t(this->tokens.size()));
+		return this->create_token_impl(kind, location, Token::Value{.integer = value});
 	};
 
 	auto TokenBuffer::createToken(Token::Kind kind, Token::Location location, float64_t value) noexcept -> Token::ID {
-		this->tokens.emplace_back(kind, location, value);
-		return Token::ID(uint32_t(this->tokens.size()));
+		return this->create_token_impl(kind, location, Token::Value{.floating_point = value});
 	};
 
-	auto TokenBuffer::createToken(Token::Kind kind, Token::Location location, std::string&& value) noexcept
+	auto TokenBuffer::createToken(Token::Kind kind, Token::Location location, std::string_view value) noexcept
 	-> Token::ID {
-		const std::unique_ptr<std::string>& saved_str = 
-			this->string_literals.emplace_back(std::make_unique<std::string>(value));
+		return this->create_token_impl(kind, location, Token::Value{.string = value});
+	};
+
+	auto TokenBuffer::createLazyLiteralToken(
+		Token::Kind kind, Token::Location location, std::string_view raw_value, core::StringInterner& interner
+	) noexcept -> Token::ID {
+		evo::debugAssert(
+			kind == Token::Kind::LiteralInt || kind == Token::Kind::LiteralFloat
+				|| kind == Token::Kind::LiteralString || kind == Token::Kind::LiteralChar,
+			"Only literals can be lazy"
+		);
+
+		const Token::ID new_token_id = this->create_token_impl(kind, location, Token::Value{.string = raw_value});
+		this->value_blocks.back().lazyValueMask |= uint64_t(1) << (new_token_id.get() % VALUE_BLOCK_SIZE);
+		this->lazy_value_interner = &interner;
+
+		return new_token_id;
+	};
+
+
+
+	auto TokenBuffer::append(const TokenBuffer& other) noexcept -> void {
+		evo::debugAssert(this->isLocked() == false, "Cannot append to a TokenBuffer that is locked");
+
+		const size_t first_new_token = this->kinds.size();
+
+		this->kinds.insert(this->kinds.end(), other.kinds.begin(), other.kinds.end());
+		this->locations.insert(this->locations.end(), other.locations.begin(), other.locations.end());
+		this->values.insert(this->values.end(), other.values.begin(), other.values.end());
+
+		if(other.lazy_value_interner != nullptr){ this->lazy_value_interner = other.lazy_value_interner; }
+
+
+		///////////////////////////////////
+		// value blocks
+		// 	(the masks of `other` are shifted to where its tokens start in this buffer, and then the number of values
+		// 	before each block is recounted for every block that changed)
+
+		const size_t first_changed_block = first_new_token / VALUE_BLOCK_SIZE;
+		const size_t shift = first_new_token % VALUE_BLOCK_SIZE;
+
+		this->value_blocks.resize((this->kinds.size() + VALUE_BLOCK_SIZE - 1) / VALUE_BLOCK_SIZE, ValueBlock(0, 0));
+
+		for(size_t i = 0; i < other.value_blocks.size(); i+=1){
+			for(uint64_t ValueBlock::* mask_member : {&ValueBlock::hasValueMask, &ValueBlock::lazyValueMask}){
+				const uint64_t mask = other.value_blocks[i].*mask_member;
+
+				this->value_blocks[first_changed_block + i].*mask_member |= mask << shift;
+
+				if(shift != 0 && first_changed_block + i + 1 < this->value_blocks.size()){
+					this->value_blocks[first_changed_block + i + 1].*mask_member |= mask >> (VALUE_BLOCK_SIZE - shift);
+				}
+			}
+		}
+
+		this->recount_values_before(first_changed_block);
+
+
+		// continues matching from the brackets of this buffer that are still open
+		for(size_t i = first_new_token; i < this->kinds.size(); i+=1){
+			this->index_bracket(Token::ID(uint32_t(i)));
+		}
+	};
+
+
+	EVO_NODISCARD static constexpr auto kind_has_string_value(Token::Kind kind) noexcept -> bool {
+		return kind == Token::Kind::LiteralString || kind == Token::Kind::LiteralChar ||
+			kind == Token::Kind::Ident || kind == Token::Kind::Intrinsic || kind == Token::Kind::Attribute;
+	};
+
+	auto TokenBuffer::moveToEditedData(
+		std::string_view old_data, std::string_view new_data, uint32_t first_moved_token, int64_t offset_shift
+	) noexcept -> void {
+		for(size_t i = first_moved_token; i < this->locations.size(); i+=1){
+			this->locations[i].offset = uint32_t(int64_t(this->locations[i].offset) + offset_shift);
+		}
+
+		const auto old_data_begin = uintptr_t(old_data.data());
+		const auto old_data_end = old_data_begin + old_data.size();
+
+		size_t value_index = 0;
+		for(size_t block_index = 0; block_index < this->value_blocks.size(); block_index+=1){
+			uint64_t mask = this->value_blocks[block_index].hasValueMask;
+
+			while(mask != 0){
+				const size_t token_index = block_index * VALUE_BLOCK_SIZE + size_t(std::countr_zero(mask));
+				mask &= mask - 1;
+
+				std::string_view& str = this->values[value_index].string;
+				value_index += 1;
+
+				const uint64_t lazy_mask = this->value_blocks[block_index].lazyValueMask;
+				const bool is_lazy = (lazy_mask >> (token_index % VALUE_BLOCK_SIZE)) & 1;
+				if(kind_has_string_value(this->kinds[token_index]) == false && is_lazy == false){ continue; }
+
+				// strings that aren't views into the source (interned) are left as is
+				const auto str_begin = uintptr_t(str.data());
+				if(str_begin < old_data_begin || str_begin > old_data_end){ continue; }
+
+				const int64_t new_str_offset = int64_t(str_begin - old_data_begin)
+					+ (token_index >= first_moved_token ? offset_shift : 0);
+
+				// tokens in the edited range are replaced after re-tokenizing
+				if(new_str_offset < 0 || size_t(new_str_offset) + str.size() > new_data.size()){ continue; }
+
+				str = std::string_view(new_data.data() + new_str_offset, str.size());
+			}
+		}
+	};
+
+
+	auto TokenBuffer::moveStringsToInterner(std::string_view data, core::StringInterner& interner) noexcept -> void {
+		const auto data_begin = uintptr_t(data.data());
+		const auto data_end = data_begin + data.size();
+
+		size_t value_index = 0;
+		for(size_t block_index = 0; block_index < this->value_blocks.size(); block_index+=1){
+			uint64_t mask = this->value_blocks[block_index].hasValueMask;
+
+			while(mask != 0){
+				const size_t token_index = block_index * VALUE_BLOCK_SIZE + size_t(std::countr_zero(mask));
+				mask &= mask - 1;
+
+				Token::Value& value = this->values[value_index];
+				value_index += 1;
+
+				// (the raw text of lazy values is a string too)
+				const uint64_t lazy_mask = this->value_blocks[block_index].lazyValueMask;
+				const bool is_lazy = (lazy_mask >> (token_index % VALUE_BLOCK_SIZE)) & 1;
+				if(kind_has_string_value(this->kinds[token_index]) == false && is_lazy == false){ continue; }
+
+				// strings that are already interned are left as is
+				const auto str_begin = uintptr_t(value.string.data());
+				if(str_begin < data_begin || str_begin >= data_end){ continue; }
+
+				value.string = interner.intern(value.string);
+			}
+		}
+	};
+
+
+	auto TokenBuffer::replaceTokens(Token::ID first_token, uint32_t num_tokens, const TokenBuffer& replacement)
+	noexcept -> void {
+		evo::debugAssert(this->isLocked() == false, "Cannot replace tokens of a TokenBuffer that is locked");
+		evo::debugAssert(first_token.get() + size_t(num_tokens) <= this->size(), "Tokens are not in the TokenBuffer");
+
+		const size_t first_index = first_token.get();
+		const size_t end_index = first_index + num_tokens;
+		const size_t old_size = this->size();
+
+		const auto num_values_before = [&](size_t token_index) noexcept -> size_t {
+			if(token_index == old_size){ return this->values.size(); }
+			return this->get_value_index(Token::ID(uint32_t(token_index)));
+		};
+
+		if(replacement.lazy_value_interner != nullptr){ this->lazy_value_interner = replacement.lazy_value_interner; }
+
+		const size_t first_value_index = num_values_before(first_index);
+		const size_t end_value_index = num_values_before(end_index);
+
+
+		///////////////////////////////////
+		// value blocks
+		// 	(the masks from the block of `first_token` onwards are rebuilt from the bits of the tokens before it in
+		// 	that block, the bits of `replacement`, and the bits of the tokens after the replaced ones)
+
+		const size_t first_changed_block = first_index / VALUE_BLOCK_SIZE;
+
+		const auto build_new_masks = [&](uint64_t ValueBlock::* mask_member) noexcept -> std::vector<uint64_t> {
+			auto new_masks = std::vector<uint64_t>();
+			uint64_t current_mask = 0;
+			size_t num_current_mask_bits = first_index % VALUE_BLOCK_SIZE;
+
+			if(num_current_mask_bits != 0){
+				current_mask = this->value_blocks[first_changed_block].*mask_member
+					& ((uint64_t(1) << num_current_mask_bits) - 1);
+			}
+
+			const auto add_mask_bits = [&](uint64_t bits, size_t num_bits) noexcept -> void {
+				if(num_bits < VALUE_BLOCK_SIZE){ bits &= (uint64_t(1) << num_bits) - 1; }
+
+				current_mask |= bits << num_current_mask_bits;
+
+				if(num_current_mask_bits + num_bits >= VALUE_BLOCK_SIZE){
+					new_masks.emplace_back(current_mask);
+
+					const size_t num_bits_used = VALUE_BLOCK_SIZE - num_current_mask_bits;
+					current_mask = num_bits_used == VALUE_BLOCK_SIZE ? 0 : bits >> num_bits_used;
+					num_current_mask_bits = num_current_mask_bits + num_bits - VALUE_BLOCK_SIZE;
+				}else{
+					num_current_mask_bits += num_bits;
+				}
+			};
+
+			for(size_t i = 0; i < replacement.size(); i += VALUE_BLOCK_SIZE){
+				add_mask_bits(
+					replacement.get_value_mask_bits(i, mask_member), std::min(VALUE_BLOCK_SIZE, replacement.size() - i)
+				);
+			}
+
+			for(size_t i = end_index; i < old_size; i += VALUE_BLOCK_SIZE){
+				add_mask_bits(this->get_value_mask_bits(i, mask_member), std::min(VALUE_BLOCK_SIZE, old_size - i));
+			}
+
+			if(num_current_mask_bits != 0){ new_masks.emplace_back(current_mask); }
+
+			return new_masks;
+		};
+
+		const std::vector<uint64_t> new_has_value_masks = build_new_masks(&ValueBlock::hasValueMask);
+		const std::vector<uint64_t> new_lazy_value_masks = build_new_masks(&ValueBlock::lazyValueMask);
+
+		this->value_blocks.resize(first_changed_block);
+		for(size_t i = 0; i < new_has_value_masks.size(); i+=1){
+			this->value_blocks.emplace_back(new_has_value_masks[i], 0, new_lazy_value_masks[i]);
+		}
+		this->recount_values_before(first_changed_block);
+
+
+		///////////////////////////////////
+		// arrays
+		// 	(overwrites as many elements as possible so a replacement of the same number of tokens doesn't have to
+		// 	move all of the elements after it)
+
+		const auto replace_elements = [](auto& vec, size_t first, size_t end, const auto& replacement_vec) noexcept {
+			const size_t num_overwritten = std::min(end - first, replacement_vec.size());
+			std::copy_n(replacement_vec.begin(), num_overwritten, vec.begin() + first);
+
+			if(replacement_vec.size() > num_overwritten){
+				const auto replacement_rest_begin = replacement_vec.begin() + num_overwritten;
+				vec.insert(vec.begin() + first + num_overwritten, replacement_rest_begin, replacement_vec.end());
+			}else{
+				vec.erase(vec.begin() + first + num_overwritten, vec.begin() + end);
+			}
+		};
+
+		replace_elements(this->kinds, first_index, end_index, replacement.kinds);
+		replace_elements(this->locations, first_index, end_index, replacement.locations);
+		replace_elements(this->values, first_value_index, end_value_index, replacement.values);
+
+		// any bracket before the replaced tokens could now be matched differently (it's just a pass over the kinds)
+		this->rebuild_bracket_index();
+	};
+
+
+	auto TokenBuffer::get(Token::ID id) const noexcept -> Token {
+		if(this->has_value(id) == false){ return Token(this->kinds[id.get()], this->locations[id.get()]); }
 
-		this->tokens.emplace_back(kind, location, std::string_view(saved_str->begin(), saved_str->end()));
-		return Token::ID(uint32_t(this->tokens.size()));
+		const size_t value_index = this->get_value_index(id);
+
+		if(this->is_lazy_value(id)){
+			return Token(this->kinds[id.get()], this->locations[id.get()], this->decode_lazy_value(id, value_index));
+		}
+
+		return Token(this->kinds[id.get()], this->locations[id.get()], this->values[value_index]);
+	};
+
+
+
+	auto TokenBuffer::create_token_impl(Token::Kind kind, Token::Location location) noexcept -> Token::ID {
+		evo::debugAssert(this->isLocked() == false, "Cannot create a token when TokenBuffer is locked");
+
+		const auto new_token_id = Token::ID(uint32_t(this->kinds.size()));
+
+		if(new_token_id.get() % VALUE_BLOCK_SIZE == 0){
+			this->value_blocks.emplace_back(0, uint32_t(this->values.size()));
+		}
+
+		this->kinds.emplace_back(kind);
+		this->locations.emplace_back(location);
+
+		this->index_bracket(new_token_id);
+
+		return new_token_id;
+	};
+
+	auto TokenBuffer::create_token_impl(Token::Kind kind, Token::Location location, const Token::Value& value)
+	noexcept -> Token::ID {
+		const Token::ID new_token_id = this->create_token_impl(kind, location);
+
+		this->value_blocks.back().hasValueMask |= uint64_t(1) << (new_token_id.get() % VALUE_BLOCK_SIZE);
+		this->values.emplace_back(value);
+
+		return new_token_id;
 	};
 
 
+	auto TokenBuffer::has_value(Token::ID id) const noexcept -> bool {
+		const ValueBlock& value_block = this->value_blocks[id.get() / VALUE_BLOCK_SIZE];
+		return (value_block.hasValueMask >> (id.get() % VALUE_BLOCK_SIZE)) & 1;
+	};
+
+	auto TokenBuffer::get_value_index(Token::ID id) const noexcept -> size_t {
+		const ValueBlock& value_block = this->value_blocks[id.get() / VALUE_BLOCK_SIZE];
+		const uint64_t values_before_in_block_mask = (uint64_t(1) << (id.get() % VALUE_BLOCK_SIZE)) - 1;
 
-	auto TokenBuffer::get(Token::ID id) const noexcept -> const Token& {
-		return this->tokens[id.get()];
+		return value_block.numValuesBefore + std::popcount(value_block.hasValueMask & values_before_in_block_mask);
 	};
 
-	auto TokenBuffer::get(Token::ID id) noexcept -> Token& {
-		evo::debugAssert(this->isLocked() == false, "Cannot get mutable token when TokenBuffer is locked");
-		return this->tokens[id.get()];
+	auto TokenBuffer::get_value_mask_bits(size_t first_token, uint64_t ValueBlock::* mask) const noexcept -> uint64_t {
+		const size_t block_index = first_token / VALUE_BLOCK_SIZE;
+		const size_t shift = first_token % VALUE_BLOCK_SIZE;
+
+		if(block_index >= this->value_blocks.size()){ return 0; }
+
+		uint64_t bits = this->value_blocks[block_index].*mask >> shift;
+		if(shift != 0 && block_index + 1 < this->value_blocks.size()){
+			bits |= this->value_blocks[block_index + 1].*mask << (VALUE_BLOCK_SIZE - shift);
+		}
+
+		return bits;
 	};
 
+	auto TokenBuffer::recount_values_before(size_t first_block) noexcept -> void {
+		for(size_t i = first_block; i < this->value_blocks.size(); i+=1){
+			if(i == 0){
+				this->value_blocks[i].numValuesBefore = 0;
+			}else{
+				const ValueBlock& previous_block = this->value_blocks[i - 1];
+				this->value_blocks[i].numValuesBefore = 
+					previous_block.numValuesBefore + uint32_t(std::popcount(previous_block.hasValueMask));
+			}
+		}
+	};
+
+
+	auto TokenBuffer::lock() noexcept -> void {
+		this->kinds.shrink_to_fit();
+		this->locations.shrink_to_fit();
+		this->values.shrink_to_fit();
+		this->value_blocks.shrink_to_fit();
+		this->bracket_blocks.shrink_to_fit();
+		this->bracket_matches.shrink_to_fit();
+		this->unclosed_brackets.shrink_to_fit();
+
+		this->is_locked = true;
+	};
+
+
+	auto TokenBuffer::getMemoryUsage() const noexcept -> MemoryUsage {
+		return MemoryUsage{
+			.kinds       = this->kinds.capacity() * sizeof(Token::Kind),
+			.locations   = this->locations.capacity() * sizeof(Token::Location),
+			.values      = this->values.capacity() * sizeof(Token::Value),
+			.valueBlocks = this->value_blocks.capacity() * sizeof(ValueBlock),
+			.bracketIndex = this->bracket_blocks.capacity() * sizeof(BracketBlock)
+				+ this->bracket_matches.capacity() * sizeof(uint32_t)
+				+ this->unclosed_brackets.capacity() * sizeof(UnclosedBracket),
+		};
+	};
+
+
+	//////////////////////////////////////////////////////////////////////
+	// bracket matching
+
+	// Token::Kind::None if not an open bracket
+	EVO_NODISCARD static constexpr auto get_close_bracket_kind(Token::Kind open_bracket_kind) noexcept -> Token::Kind {
+		switch(open_bracket_kind){
+			case Token::Kind::OpenParen:   return Token::Kind::CloseParen;
+			case Token::Kind::OpenBracket: return Token::Kind::CloseBracket;
+			case Token::Kind::OpenBrace:   return Token::Kind::CloseBrace;
+			default:                       return Token::Kind::None;
+		};
+	};
+
+	EVO_NODISCARD static constexpr auto is_close_bracket(Token::Kind kind) noexcept -> bool {
+		return kind == Token::Kind::CloseParen || kind == Token::Kind::CloseBracket || kind == Token::Kind::CloseBrace;
+	};
+
+
+	auto TokenBuffer::getMatchingBracket(Token::ID open_bracket) const noexcept -> std::optional<Token::ID> {
+		evo::debugAssert(
+			get_close_bracket_kind(this->getKind(open_bracket)) != Token::Kind::None, "Token is not an open bracket"
+		);
+
+		const BracketBlock& bracket_block = this->bracket_blocks[open_bracket.get() / VALUE_BLOCK_SIZE];
+		const uint64_t brackets_before_in_block_mask = (uint64_t(1) << (open_bracket.get() % VALUE_BLOCK_SIZE)) - 1;
+		const size_t match_index = bracket_block.numOpenBracketsBefore
+			+ size_t(std::popcount(bracket_block.openBracketMask & brackets_before_in_block_mask));
+
+		const uint32_t close_bracket = this->bracket_matches[match_index];
+		if(close_bracket == NO_MATCHING_BRACKET){ return std::nullopt; }
+
+		return Token::ID(close_bracket);
+	};
+
+
+	auto TokenBuffer::getUnbalancedBracket() const noexcept -> std::optional<UnbalancedBracket> {
+		if(this->first_unmatched_close_bracket.has_value()){ return this->first_unmatched_close_bracket; }
+
+		if(this->unclosed_brackets.empty() == false){
+			return UnbalancedBracket(this->unclosed_brackets.back().id, std::nullopt);
+		}
+
+		return std::nullopt;
+	};
+
+
+	auto TokenBuffer::index_bracket(Token::ID id) noexcept -> void {
+		if(id.get() % VALUE_BLOCK_SIZE == 0){
+			this->bracket_blocks.emplace_back(0, uint32_t(this->bracket_matches.size()));
+		}
+
+		const Token::Kind kind = this->kinds[id.get()];
+
+		if(get_close_bracket_kind(kind) != Token::Kind::None){
+			this->bracket_blocks.back().openBracketMask |= uint64_t(1) << (id.get() % VALUE_BLOCK_SIZE);
+			this->unclosed_brackets.emplace_back(id, uint32_t(this->bracket_matches.size()));
+			this->bracket_matches.emplace_back(NO_MATCHING_BRACKET);
+			return;
+		}
+
+		if(is_close_bracket(kind) == false || this->first_unmatched_close_bracket.has_value()){ return; }
+
+		if(this->unclosed_brackets.empty()){
+			this->first_unmatched_close_bracket = UnbalancedBracket(std::nullopt, id);
+			return;
+		}
+
+		const UnclosedBracket& open_bracket = this->unclosed_brackets.back();
+		if(get_close_bracket_kind(this->kinds[open_bracket.id.get()]) != kind){
+			this->first_unmatched_close_bracket = UnbalancedBracket(open_bracket.id, id);
+			return;
+		}
+
+		this->bracket_matches[open_bracket.matchIndex] = id.get();
+		this->unclosed_brackets.pop_back();
+	};
+
+
+	auto TokenBuffer::rebuild_bracket_index() noexcept -> void {
+		this->bracket_blocks.clear();
+		this->bracket_matches.clear();
+		this->unclosed_brackets.clear();
+		this->first_unmatched_close_bracket.reset();
+
+		for(size_t i = 0; i < this->kinds.size(); i+=1){
+			this->index_bracket(Token::ID(uint32_t(i)));
+		}
+	};
+
+
+	//////////////////////////////////////////////////////////////////////
+	// lazy values
+
+	EVO_NODISCARD static auto decode_raw_value(
+		Token::Kind kind, std::string_view raw_value, core::StringInterner& interner
+	) noexcept -> Token::Value {
+		switch(kind){
+			case Token::Kind::LiteralInt: {
+				const std::optional<uint64_t> decoded_int = literal_decoding::decodeInt(
+					literal_decoding::splitNumberLiteral(raw_value)
+				);
+				evo::debugAssert(decoded_int.has_value(), "Lazy literal integer is too large");
+
+				return Token::Value{.integer = *decoded_int};
+			};
+
+			case Token::Kind::LiteralFloat: {
+				const literal_decoding::DecodedFloat decoded_float = literal_decoding::decodeFloat(
+					literal_decoding::splitNumberLiteral(raw_value)
+				);
+				evo::debugAssert(decoded_float.ec == std::errc(), "Lazy literal floating-point is invalid");
+
+				return Token::Value{.floating_point = decoded_float.value};
+			};
+
+			case Token::Kind::LiteralString: case Token::Kind::LiteralChar: {
+				return Token::Value{.string = interner.intern(literal_decoding::decodeText(raw_value))};
+			};
+		};
+
+		evo::debugFatalBreak("Unknown or unsupported lazy literal kind");
+	};
+
+
+	auto TokenBuffer::is_lazy_value(Token::ID id) const noexcept -> bool {
+		const ValueBlock& value_block = this->value_blocks[id.get() / VALUE_BLOCK_SIZE];
+		const uint64_t lazy_value_mask = std::atomic_ref<uint64_t>(value_block.lazyValueMask).load(
+			std::memory_order_acquire
+		);
+
+		return (lazy_value_mask >> (id.get() % VALUE_BLOCK_SIZE)) & 1;
+	};
+
+	// Only the thread that sets the bit of the value in `lazyValueClaimedMask` decodes it and writes the value, and
+	// 		then clears the bit in `lazyValueMask` (with release), so a thread that sees that bit cleared can read
+	// 		the value. Any other thread getting it at the same time waits for that instead (there are no locks, so
+	// 		getting different values never contends).
+	auto TokenBuffer::decode_lazy_value(Token::ID id, size_t value_index) const noexcept -> Token::Value {
+		const ValueBlock& value_block = this->value_blocks[id.get() / VALUE_BLOCK_SIZE];
+		auto lazy_value_mask = std::atomic_ref<uint64_t>(value_block.lazyValueMask);
+		auto lazy_value_claimed_mask = std::atomic_ref<uint64_t>(value_block.lazyValueClaimedMask);
+		const uint64_t lazy_value_bit = uint64_t(1) << (id.get() % VALUE_BLOCK_SIZE);
+
+		Token::Value& value = this->values[value_index];
+
+		const uint64_t claimed_before = lazy_value_claimed_mask.fetch_or(lazy_value_bit, std::memory_order_relaxed);
+		if((claimed_before & lazy_value_bit) == 0){
+			value = decode_raw_value(this->kinds[id.get()], value.string, *this->lazy_value_interner);
+			lazy_value_mask.fetch_and(~lazy_value_bit, std::memory_order_release);
+			lazy_value_mask.notify_all();
+			return value;
+		}
+
+		// waits for every change of the mask as the other values of the block are decoded too
+		uint64_t current_lazy_value_mask = lazy_value_mask.load(std::memory_order_acquire);
+		while(current_lazy_value_mask & lazy_value_bit){
+			lazy_value_mask.wait(current_lazy_value_mask, std::memory_order_acquire);
+			current_lazy_value_mask = lazy_value_mask.load(std::memory_order_acquire);
+		}
+
+		return value;
+	};
 
 
-};
\ No newline at end of file
+};
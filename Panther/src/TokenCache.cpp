@@ -0,0 +1,487 @@
+//////////////////////////////////////////////////////////////////////
+//                                                                  //
+// Part of the PCIT-CPP, under the Apache License v2.0              //
+// You may not use this file except in compliance with the License. //
+// See `http://www.apache.org/licenses/LICENSE-2.0` for info        //
+//                                                                  //
+//////////////////////////////////////////////////////////////////////
+
+
+#include "./TokenCache.h"
+
+#include <bit>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <thread>
+
+namespace pcit::panther{
+
+	//////////////////////////////////////////////////////////////////////
+	// file format
+	// 	(native endianness, a cache directory is not meant to be shared between machines)
+	//
+	// 	Header
+	// 	Token::Kind[numTokens]          (padded to 8 bytes)
+	// 	Token::Location[numTokens]
+	// 	uint64_t[numValueBlocks]        (hasValueMask of each value block)
+	// 	uint64_t[numValueBlocks]        (lazyValueMask of each value block)
+	// 	EncodedValue[numValues]         (lazy values are encoded as strings of their raw text)
+	// 	char[stringsSize]               (strings of values that aren't views into the source data)
+
+	// change whenever the format changes (or anything about how tokens are stored)
+	static constexpr uint32_t FORMAT_VERSION = 3;
+	static constexpr uint32_t MAGIC = 0x43'4B'54'50; // "PTKC"
+
+	struct Header{
+		uint32_t magic;
+		uint32_t formatVersion;
+		core::Version compilerVersion;
+		uint64_t dataHash;
+		uint64_t dataSize;
+		uint32_t numTokens;
+		uint32_t numValues;
+		uint64_t stringsSize;
+	};
+
+	// strings are an offset into the source data, or into the strings section if `IN_STRINGS_SECTION` is set
+	union EncodedValue{
+		uint64_t integer;
+		struct{
+			uint32_t offset;
+			uint32_t size;
+		} string;
+	};
+	static_assert(sizeof(EncodedValue) == sizeof(uint64_t));
+
+	static constexpr uint32_t IN_STRINGS_SECTION = uint32_t(1) << 31;
+
+
+	EVO_NODISCARD static constexpr auto align_to_8(size_t size) noexcept -> size_t {
+		return (size + 7) & ~size_t(7);
+	};
+
+	EVO_NODISCARD static constexpr auto get_file_size(const Header& header) noexcept -> size_t {
+		const size_t num_value_blocks = (size_t(header.numTokens) + 63) / 64;
+
+		return sizeof(Header)
+			+ align_to_8(header.numTokens * sizeof(Token::Kind))
+			+ header.numTokens * sizeof(Token::Location)
+			+ num_value_blocks * sizeof(uint64_t) * 2
+			+ header.numValues * sizeof(EncodedValue)
+			+ header.stringsSize;
+	};
+
+
+	EVO_NODISCARD static constexpr auto version_is_same(const core::Version& lhs, const core::Version& rhs) noexcept
+	-> bool {
+		return lhs.major == rhs.major && lhs.release == rhs.release && lhs.minor == rhs.minor && lhs.patch == rhs.patch;
+	};
+
+
+
+	//////////////////////////////////////////////////////////////////////
+	// hashing
+	// 	(XXH64)
+
+	static constexpr uint64_t PRIME_1 = 11400714785074694791ull;
+	static constexpr uint64_t PRIME_2 = 14029467366897019727ull;
+	static constexpr uint64_t PRIME_3 = 1609587929392839161ull;
+	static constexpr uint64_t PRIME_4 = 9650029242287828579ull;
+	static constexpr uint64_t PRIME_5 = 2870177450012600261ull;
+
+	EVO_NODISCARD static auto read_64(const char* ptr) noexcept -> uint64_t {
+		uint64_t value;
+		std::memcpy(&value, ptr, sizeof(uint64_t));
+		return value;
+	};
+
+	EVO_NODISCARD static auto read_32(const char* ptr) noexcept -> uint32_t {
+		uint32_t value;
+		std::memcpy(&value, ptr, sizeof(uint32_t));
+		return value;
+	};
+
+	EVO_NODISCARD static constexpr auto hash_round(uint64_t acc, uint64_t input) noexcept -> uint64_t {
+		return std::rotl(acc + input * PRIME_2, 31) * PRIME_1;
+	};
+
+	EVO_NODISCARD static constexpr auto hash_merge_round(uint64_t acc, uint64_t value) noexcept -> uint64_t {
+		return (acc ^ hash_round(0, value)) * PRIME_1 + PRIME_4;
+	};
+
+	EVO_NODISCARD static auto hash(std::string_view data, uint64_t seed) noexcept -> uint64_t {
+		const char* ptr = data.data();
+		const char* const end = ptr + data.size();
+
+		uint64_t hash_value;
+
+		if(data.size() >= 32){
+			uint64_t acc_1 = seed + PRIME_1 + PRIME_2;
+			uint64_t acc_2 = seed + PRIME_2;
+			uint64_t acc_3 = seed;
+			uint64_t acc_4 = seed - PRIME_1;
+
+			for(; ptr + 32 <= end; ptr += 32){
+				acc_1 = hash_round(acc_1, read_64(ptr));
+				acc_2 = hash_round(acc_2, read_64(ptr + 8));
+				acc_3 = hash_round(acc_3, read_64(ptr + 16));
+				acc_4 = hash_round(acc_4, read_64(ptr + 24));
+			}
+
+			hash_value = std::rotl(acc_1, 1) + std::rotl(acc_2, 7) + std::rotl(acc_3, 12) + std::rotl(acc_4, 18);
+			hash_value = hash_merge_round(hash_value, acc_1);
+			hash_value = hash_merge_round(hash_value, acc_2);
+			hash_value = hash_merge_round(hash_value, acc_3);
+			hash_value = hash_merge_round(hash_value, acc_4);
+
+		}else{
+			hash_value = seed + PRIME_5;
+		}
+
+		hash_value += uint64_t(data.size());
+
+		for(; ptr + 8 <= end; ptr += 8){
+			hash_value ^= hash_round(0, read_64(ptr));
+			hash_value = std::rotl(hash_value, 27) * PRIME_1 + PRIME_4;
+		}
+
+		if(ptr + 4 <= end){
+			hash_value ^= uint64_t(read_32(ptr)) * PRIME_1;
+			hash_value = std::rotl(hash_value, 23) * PRIME_2 + PRIME_3;
+			ptr += 4;
+		}
+
+		for(; ptr < end; ptr += 1){
+			hash_value ^= uint64_t(uint8_t(*ptr)) * PRIME_5;
+			hash_value = std::rotl(hash_value, 11) * PRIME_1;
+		}
+
+		hash_value ^= hash_value >> 33;
+		hash_value *= PRIME_2;
+		hash_value ^= hash_value >> 29;
+		hash_value *= PRIME_3;
+		hash_value ^= hash_value >> 32;
+
+		return hash_value;
+	};
+
+
+
+	//////////////////////////////////////////////////////////////////////
+	// token cache
+
+	auto TokenCache::getKey(const Source& source) noexcept -> uint64_t {
+		// the compiler and format version are part of the seed so different versions never share a file
+		const uint64_t seed = (uint64_t(core::version.major) << 48) | (uint64_t(core::version.release) << 32)
+			| (uint64_t(core::version.minor) << 16) | uint64_t(core::version.patch);
+
+		return hash(source.getData(), seed ^ (uint64_t(FORMAT_VERSION) * PRIME_3));
+	};
+
+
+	auto TokenCache::load(const Source& source, uint64_t key) noexcept -> std::optional<TokenBuffer> {
+		auto mapped_file = core::MappedFile();
+		if(mapped_file.open(this->get_file_path(key)) == false){ return std::nullopt; }
+
+		const std::string_view file_data = mapped_file.getData();
+		const std::string_view source_data = source.getData();
+
+
+		///////////////////////////////////
+		// check header
+
+		if(file_data.size() < sizeof(Header)){ return std::nullopt; }
+
+		Header header;
+		std::memcpy(&header, file_data.data(), sizeof(Header));
+
+		if(
+			header.magic != MAGIC
+			|| header.formatVersion != FORMAT_VERSION
+			|| version_is_same(header.compilerVersion, core::version) == false
+			|| header.dataHash != key
+			|| header.dataSize != source_data.size()
+			|| get_file_size(header) != file_data.size()
+		){
+			return std::nullopt;
+		}
+
+
+		///////////////////////////////////
+		// read sections
+
+		auto token_buffer = TokenBuffer();
+
+		size_t cursor = sizeof(Header);
+
+		token_buffer.kinds.resize(header.numTokens);
+		std::memcpy(token_buffer.kinds.data(), file_data.data() + cursor, header.numTokens * sizeof(Token::Kind));
+		cursor += align_to_8(header.numTokens * sizeof(Token::Kind));
+
+		token_buffer.locations.resize(header.numTokens);
+		std::memcpy(
+			token_buffer.locations.data(), file_data.data() + cursor, header.numTokens * sizeof(Token::Location)
+		);
+		cursor += header.numTokens * sizeof(Token::Location);
+
+		const size_t num_value_blocks = (size_t(header.numTokens) + TokenBuffer::VALUE_BLOCK_SIZE - 1)
+			/ TokenBuffer::VALUE_BLOCK_SIZE;
+		token_buffer.value_blocks.reserve(num_value_blocks);
+		size_t num_values_in_masks = 0;
+		for(size_t i = 0; i < num_value_blocks; i+=1){
+			const uint64_t mask = read_64(file_data.data() + cursor + i * sizeof(uint64_t));
+			token_buffer.value_blocks.emplace_back(mask, 0);
+			num_values_in_masks += size_t(std::popcount(mask));
+		}
+		token_buffer.recount_values_before(0);
+		cursor += num_value_blocks * sizeof(uint64_t);
+
+		if(num_values_in_masks != header.numValues){ return std::nullopt; }
+
+		for(size_t i = 0; i < num_value_blocks; i+=1){
+			const uint64_t lazy_mask = read_64(file_data.data() + cursor + i * sizeof(uint64_t));
+			if((lazy_mask & ~token_buffer.value_blocks[i].hasValueMask) != 0){ return std::nullopt; }
+
+			token_buffer.value_blocks[i].lazyValueMask = lazy_mask;
+		}
+		cursor += num_value_blocks * sizeof(uint64_t);
+
+		const size_t num_tokens_in_last_block = header.numTokens % TokenBuffer::VALUE_BLOCK_SIZE;
+		if(
+			num_tokens_in_last_block != 0
+			&& (token_buffer.value_blocks.back().hasValueMask >> num_tokens_in_last_block) != 0
+		){
+			return std::nullopt;
+		}
+
+		// the value of a token is decoded by its kind, so it must be a kind that has a value
+		for(size_t i = 0; i < token_buffer.kinds.size(); i+=1){
+			const Token::Kind kind = token_buffer.kinds[i];
+			const uint64_t mask = token_buffer.value_blocks[i / TokenBuffer::VALUE_BLOCK_SIZE].hasValueMask;
+			const bool has_value = (mask >> (i % TokenBuffer::VALUE_BLOCK_SIZE)) & 1;
+
+			if(Token::isValidKind(kind) == false || Token::kindHasValue(kind) != has_value){ return std::nullopt; }
+		}
+
+		const char* encoded_values = file_data.data() + cursor;
+		cursor += header.numValues * sizeof(EncodedValue);
+
+		const std::string_view strings_section = file_data.substr(cursor, header.stringsSize);
+
+
+		// a cache file could have been corrupted, so anything that could be used to read out of bounds is checked
+		for(const Token::Location& location : token_buffer.locations){
+			if(size_t(location.offset) + location.length > source_data.size()){ return std::nullopt; }
+		}
+
+
+		///////////////////////////////////
+		// decode values
+
+		token_buffer.values.reserve(header.numValues);
+
+		for(size_t block_index = 0; block_index < token_buffer.value_blocks.size(); block_index+=1){
+			uint64_t mask = token_buffer.value_blocks[block_index].hasValueMask;
+
+			while(mask != 0){
+				const size_t token_index = block_index * TokenBuffer::VALUE_BLOCK_SIZE + size_t(std::countr_zero(mask));
+				mask &= mask - 1;
+
+				EncodedValue encoded_value;
+				std::memcpy(
+					&encoded_value, encoded_values + token_buffer.values.size() * sizeof(EncodedValue), sizeof(uint64_t)
+				);
+
+				const Token::Kind kind = token_buffer.kinds[token_index];
+
+				const uint64_t lazy_mask = token_buffer.value_blocks[block_index].lazyValueMask;
+				const bool is_lazy = (lazy_mask >> (token_index % TokenBuffer::VALUE_BLOCK_SIZE)) & 1;
+				if(is_lazy){
+					if(
+						kind != Token::Kind::LiteralInt && kind != Token::Kind::LiteralFloat
+						&& kind != Token::Kind::LiteralString && kind != Token::Kind::LiteralChar
+					){
+						return std::nullopt;
+					}
+
+					token_buffer.lazy_value_interner = &this->context.getStringInterner();
+				}
+
+				// lazy values are strings of their raw text
+				switch(is_lazy ? Token::Kind::LiteralString : kind){
+					break; case Token::Kind::LiteralBool: {
+						token_buffer.values.emplace_back(Token::Value{.boolean = encoded_value.integer != 0});
+					}
+
+					break; case Token::Kind::LiteralInt: {
+						token_buffer.values.emplace_back(Token::Value{.integer = encoded_value.integer});
+					}
+
+					break; case Token::Kind::LiteralFloat: {
+						token_buffer.values.emplace_back(
+							Token::Value{.floating_point = std::bit_cast<float64_t>(encoded_value.integer)}
+						);
+					}
+
+					break; default: {
+						const size_t offset = encoded_value.string.offset;
+						const size_t size = encoded_value.string.size & ~IN_STRINGS_SECTION;
+
+						if(encoded_value.string.size & IN_STRINGS_SECTION){
+							if(offset + size > strings_section.size()){ return std::nullopt; }
+
+							// interned so it outlives the mapped file
+							const std::string_view str = this->context.getStringInterner().intern(
+								strings_section.substr(offset, size)
+							);
+							token_buffer.values.emplace_back(Token::Value{.string = str});
+
+						}else{
+							if(offset + size > source_data.size()){ return std::nullopt; }
+
+							token_buffer.values.emplace_back(Token::Value{.string = source_data.substr(offset, size)});
+						}
+					}
+				};
+			}
+		}
+
+		// not saved as it's just a pass over the kinds
+		token_buffer.rebuild_bracket_index();
+
+		return token_buffer;
+	};
+
+
+	auto TokenCache::save(const Source& source, uint64_t key, const TokenBuffer& token_buffer) noexcept -> void {
+		const std::string_view source_data = source.getData();
+
+		///////////////////////////////////
+		// encode values
+
+		auto encoded_values = std::vector<EncodedValue>();
+		encoded_values.reserve(token_buffer.values.size());
+
+		auto strings_section = std::string();
+
+		size_t value_index = 0;
+		for(size_t block_index = 0; block_index < token_buffer.value_blocks.size(); block_index+=1){
+			uint64_t mask = token_buffer.value_blocks[block_index].hasValueMask;
+
+			while(mask != 0){
+				const size_t token_index = block_index * TokenBuffer::VALUE_BLOCK_SIZE + size_t(std::countr_zero(mask));
+				mask &= mask - 1;
+
+				const Token::Value& value = token_buffer.values[value_index];
+				value_index += 1;
+
+				auto encoded_value = EncodedValue{.integer = 0};
+
+				// lazy values are strings of their raw text
+				const uint64_t lazy_mask = token_buffer.value_blocks[block_index].lazyValueMask;
+				const bool is_lazy = (lazy_mask >> (token_index % TokenBuffer::VALUE_BLOCK_SIZE)) & 1;
+
+				switch(is_lazy ? Token::Kind::LiteralString : token_buffer.kinds[token_index]){
+					break; case Token::Kind::LiteralBool:  encoded_value.integer = uint64_t(value.boolean);
+					break; case Token::Kind::LiteralInt:   encoded_value.integer = value.integer;
+					break; case Token::Kind::LiteralFloat: {
+						encoded_value.integer = std::bit_cast<uint64_t>(value.floating_point);
+					}
+
+					break; default: {
+						if(value.string.size() >= IN_STRINGS_SECTION){ return; }
+
+						const auto str_begin = uintptr_t(value.string.data());
+						const auto source_data_begin = uintptr_t(source_data.data());
+
+						if(str_begin >= source_data_begin && str_begin <= source_data_begin + source_data.size()){
+							encoded_value.string.offset = uint32_t(str_begin - source_data_begin);
+							encoded_value.string.size = uint32_t(value.string.size());
+
+						}else{
+							if(strings_section.size() + value.string.size() >= IN_STRINGS_SECTION){ return; }
+
+							encoded_value.string.offset = uint32_t(strings_section.size());
+							encoded_value.string.size = uint32_t(value.string.size()) | IN_STRINGS_SECTION;
+							strings_section += value.string;
+						}
+					}
+				};
+
+				encoded_values.emplace_back(encoded_value);
+			}
+		}
+
+
+		///////////////////////////////////
+		// write
+
+		const auto header = Header{
+			.magic           = MAGIC,
+			.formatVersion   = FORMAT_VERSION,
+			.compilerVersion = core::version,
+			.dataHash        = key,
+			.dataSize        = source_data.size(),
+			.numTokens       = uint32_t(token_buffer.size()),
+			.numValues       = uint32_t(encoded_values.size()),
+			.stringsSize     = strings_section.size(),
+		};
+
+		auto ec = std::error_code();
+		fs::create_directories(this->directory, ec);
+		if(ec){ return; }
+
+		const fs::path file_path = this->get_file_path(key);
+		// unique to this thread (and, almost certainly, process) so concurrent writers never share a temporary file
+		const fs::path temp_file_path = std::format(
+			"{}.{:x}-{:x}.tmp",
+			file_path.string(),
+			std::hash<std::thread::id>{}(std::this_thread::get_id()),
+			uint64_t(std::chrono::steady_clock::now().time_since_epoch().count())
+		);
+
+		{
+			auto file = std::ofstream(temp_file_path, std::ios::binary | std::ios::trunc);
+			if(file.is_open() == false){ return; }
+
+			const auto write = [&](const void* data, size_t size) noexcept -> void {
+				file.write(static_cast<const char*>(data), std::streamsize(size));
+			};
+
+			static constexpr uint64_t padding = 0;
+			const size_t kinds_size = token_buffer.kinds.size() * sizeof(Token::Kind);
+			const size_t num_value_blocks = token_buffer.value_blocks.size();
+
+			write(&header, sizeof(Header));
+			write(token_buffer.kinds.data(), kinds_size);
+			write(&padding, align_to_8(kinds_size) - kinds_size);
+			write(token_buffer.locations.data(), token_buffer.locations.size() * sizeof(Token::Location));
+			for(size_t i = 0; i < num_value_blocks; i+=1){
+				write(&token_buffer.value_blocks[i].hasValueMask, sizeof(uint64_t));
+			}
+			for(size_t i = 0; i < num_value_blocks; i+=1){
+				write(&token_buffer.value_blocks[i].lazyValueMask, sizeof(uint64_t));
+			}
+			write(encoded_values.data(), encoded_values.size() * sizeof(EncodedValue));
+			write(strings_section.data(), strings_section.size());
+
+			if(file.good() == false){
+				file.close();
+				fs::remove(temp_file_path, ec);
+				return;
+			}
+		}
+
+		// renaming replaces the file in one step so a partially written file is never used
+		fs::rename(temp_file_path, file_path, ec);
+		if(ec){ fs::remove(temp_file_path, ec); }
+	};
+
+
+	auto TokenCache::get_file_path(uint64_t key) const noexcept -> fs::path {
+		return this->directory / std::format("{:016x}.ptok", key);
+	};
+
+
+};
@@ -0,0 +1,51 @@
+//////////////////////////////////////////////////////////////////////
+//                                                                  //
+// Part of the PCIT-CPP, under the Apache License v2.0              //
+// You may not use this file except in compliance with the License. //
+// See `http://www.apache.org/licenses/LICENSE-2.0` for info        //
+//                                                                  //
+//////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+
+#include <Evo.h>
+#include <PCIT_core.h>
+
+#include "../include/Context.h"
+#include "../include/TokenBuffer.h"
+
+namespace pcit::panther{
+
+
+	// On-disk cache of the tokens of sources (enabled with `Context::Config::tokenCacheDirectory`).
+	// Each file is keyed by a hash of the source data and the compiler version, and also stores the hash, size of the
+	// 		data, and compiler version to check against, so a cached TokenBuffer is only used for a source with the
+	// 		same data and is never used by a different version of the compiler.
+	// Files are written to a temporary file first and then renamed, so other processes never see a partial file.
+	class TokenCache{
+		public:
+			TokenCache(Context& _context, const fs::path& _directory) noexcept
+				: context(_context), directory(_directory) {};
+			~TokenCache() = default;
+
+			// hash of the source data used as the key (fast enough to not matter next to tokenizing)
+			EVO_NODISCARD static auto getKey(const Source& source) noexcept -> uint64_t;
+
+			// returns nullopt if there's no valid cached token buffer for the source
+			EVO_NODISCARD auto load(const Source& source, uint64_t key) noexcept -> std::optional<TokenBuffer>;
+
+			// failing to save is not an error (the source is just re-tokenized next time)
+			auto save(const Source& source, uint64_t key, const TokenBuffer& token_buffer) noexcept -> void;
+
+		private:
+			EVO_NODISCARD auto get_file_path(uint64_t key) const noexcept -> fs::path;
+
+		private:
+			Context& context;
+			const fs::path& directory;
+	};
+
+
+};
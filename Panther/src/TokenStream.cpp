@@ -0,0 +1,75 @@
+//////////////////////////////////////////////////////////////////////
+//                                                                  //
+// Part of the PCIT-CPP, under the Apache License v2.0              //
+// You may not use this file except in compliance with the License. //
+// See `http://www.apache.org/licenses/LICENSE-2.0` for info        //
+//                                                                  //
+//////////////////////////////////////////////////////////////////////
+
+
+#include "../include/TokenStream.h"
+
+#include "./Tokenizer.h"
+
+namespace pcit::panther{
+
+
+	TokenStream::TokenStream(Context& context, Source::ID source_id) noexcept
+		: tokenizer(std::make_unique<Tokenizer>(context, source_id)) {};
+
+	TokenStream::~TokenStream() noexcept = default;
+
+
+	auto TokenStream::peek(size_t num_ahead) noexcept -> std::optional<Token> {
+		evo::debugAssert(num_ahead < MAX_LOOKAHEAD, "Cannot peek further ahead than `MAX_LOOKAHEAD`");
+
+		while(this->num_lookahead <= num_ahead){
+			if(this->buffer_next_token() == false){ return std::nullopt; }
+		};
+
+		return this->lookahead[(this->first_lookahead + num_ahead) % MAX_LOOKAHEAD];
+	};
+
+
+	auto TokenStream::next() noexcept -> std::optional<Token> {
+		const std::optional<Token> token = this->peek();
+		if(token.has_value()){ this->skip(); }
+		return token;
+	};
+
+
+	auto TokenStream::skip() noexcept -> void {
+		if(this->num_lookahead == 0){
+			const bool has_next_token = this->buffer_next_token();
+			evo::debugAssert(has_next_token, "No token to skip");
+		}
+
+		this->first_lookahead = (this->first_lookahead + 1) % MAX_LOOKAHEAD;
+		this->num_lookahead -= 1;
+	};
+
+
+	auto TokenStream::buffer_next_token() noexcept -> bool {
+		if(this->reached_end){ return false; }
+
+		evo::Result<std::optional<Token>> result = this->tokenizer->tokenizeNextToken();
+
+		if(result.isError()){
+			this->has_errored = true;
+			this->reached_end = true;
+			this->num_lookahead = 0;
+			return false;
+		}
+
+		if(result.value().has_value() == false){
+			this->reached_end = true;
+			return false;
+		}
+
+		this->lookahead[(this->first_lookahead + this->num_lookahead) % MAX_LOOKAHEAD] = *result.value();
+		this->num_lookahead += 1;
+		return true;
+	};
+
+
+};
@@ -9,35 +9,257 @@
 
 #include "./Tokenizer.h"
 
+#include "./char_scanning.h"
+#include "./literal_decoding.h"
+
 
 namespace pcit::panther{
+
+
+	// which sub-lexer a token starting with a given character is handled by
+	enum class CharClass : uint8_t {
+		Unrecognized,
+		Whitespace,
+		Slash, // comments (or operators)
+		IdentifierStart,
+		IntrinsicOrAttributeStart,
+		Operator, // operators and punctuation
+		Number,
+		TextDelimiter,
+	};
+
+	static constexpr auto char_class_table = [](){
+		auto table = std::array<CharClass, 256>();
+		table.fill(CharClass::Unrecognized);
+
+		for(const Token::KindSpec& spec : Token::KIND_SPECS){
+			if(spec.category == Token::SpellingCategory::Operator){
+				table[uint8_t(spec.spelling[0])] = CharClass::Operator;
+			}
+		}
+
+		for(const char c : std::string_view(" \t\n\r\v\f")){ table[uint8_t(c)] = CharClass::Whitespace; }
+
+		table[uint8_t('/')] = CharClass::Slash;
+
+		for(char c = 'a'; c <= 'z'; c+=1){ table[uint8_t(c)] = CharClass::IdentifierStart; }
+		for(char c = 'A'; c <= 'Z'; c+=1){ table[uint8_t(c)] = CharClass::IdentifierStart; }
+		table[uint8_t('_')] = CharClass::IdentifierStart;
+
+		table[uint8_t('@')] = CharClass::IntrinsicOrAttributeStart;
+		table[uint8_t('#')] = CharClass::IntrinsicOrAttributeStart;
+
+		for(char c = '0'; c <= '9'; c+=1){ table[uint8_t(c)] = CharClass::Number; }
+
+		table[uint8_t('"')] = CharClass::TextDelimiter;
+		table[uint8_t('\'')] = CharClass::TextDelimiter;
+
+		return table;
+	}();
+
+	static_assert(
+		std::ranges::all_of(
+			Token::KIND_SPECS,
+			[](const Token::KindSpec& spec){
+				if(spec.category != Token::SpellingCategory::Operator){ return true; }
+				const CharClass char_class = char_class_table[uint8_t(spec.spelling[0])];
+				return char_class == CharClass::Operator || char_class == CharClass::Slash;
+			}
+		),
+		"Operators can't start with a character that starts a different kind of token (other than '/')"
+	);
 	
 
 	auto Tokenizer::tokenize() noexcept -> evo::Result<TokenBuffer> {
-		while(this->char_stream.at_end() == false && this->context.hasHitFailCondition() == false){
-			this->current_token_line_start = this->char_stream.get_line();
-			this->current_token_collumn_start = this->char_stream.get_collumn();
-
-			if(this->tokenize_whitespace()    ){ continue; }
-			if(this->tokenize_comment()       ){ continue; }
-			if(this->tokenize_identifier()    ){ continue; }
-			if(this->tokenize_operators()     ){ continue; }
-			if(this->tokenize_punctuation()   ){ continue; }
-			if(this->tokenize_number_literal()){ continue; }
-			if(this->tokenize_string_literal()){ continue; }
+		const bool tokenize_succeeded = this->tokenize_impl([](uint32_t) noexcept -> bool { return false; });
+
+		// tokenizing stops early when a stop is requested, so the tokens may be incomplete
+		if(tokenize_succeeded == false || this->emitted_error || this->stop_token.stop_requested()){
+			return evo::resultError;
+		}
+
+		return std::move(this->token_buffer);
+	};
+
+
+	auto Tokenizer::tokenizeNextToken() noexcept -> evo::Result<std::optional<Token>> {
+		this->is_streaming = true;
+		this->streamed_token.reset();
+
+		const bool tokenize_succeeded = this->tokenize_impl([&](uint32_t) noexcept -> bool {
+			return this->streamed_token.has_value();
+		});
+
+		// tokenizing stops early when a stop is requested, so it may not be the next token
+		if(tokenize_succeeded == false || this->emitted_error || this->stop_token.stop_requested()){
+			return evo::resultError;
+		}
+
+		return std::exchange(this->streamed_token, std::nullopt);
+	};
+
+
+	auto Tokenizer::tokenizeUntilResync(const TokenBuffer& old_tokens, uint32_t first_resync_candidate) noexcept
+	-> evo::Result<ResyncResult> {
+		uint32_t resync_candidate = first_resync_candidate;
+
+		const bool tokenize_succeeded = this->tokenize_impl([&](uint32_t offset) noexcept -> bool {
+			while(
+				resync_candidate < old_tokens.size()
+				&& old_tokens.getLocation(Token::ID(resync_candidate)).offset < offset
+			){
+				resync_candidate += 1;
+			}
+
+			return resync_candidate < old_tokens.size()
+				&& old_tokens.getLocation(Token::ID(resync_candidate)).offset == offset;
+		});
+
+		// tokenizing stops early when a stop is requested, so the tokens may not have resynced
+		if(tokenize_succeeded == false || this->emitted_error || this->stop_token.stop_requested()){
+			return evo::resultError;
+		}
+
+		const uint32_t resync_token = this->char_stream.at_end() ? uint32_t(old_tokens.size()) : resync_candidate;
+		return ResyncResult(std::move(this->token_buffer), resync_token);
+	};
+
+
+	auto Tokenizer::tokenize_impl(auto&& should_stop) noexcept -> bool {
+		// starts at 1 so it checks before the first token
+		uint32_t num_until_cancellation_check = 1;
+
+		while(this->char_stream.at_end() == false){
+			num_until_cancellation_check -= 1;
+			if(num_until_cancellation_check == 0){
+				if(this->stop_token.stop_requested()){ break; }
+				num_until_cancellation_check = CANCELLATION_CHECK_INTERVAL;
+			}
+
+			this->current_token_start = this->char_stream.get_offset();
+
+			if(should_stop(this->current_token_start)){ break; }
+
+			const bool consumed_source = [&]() noexcept -> bool {
+				switch(char_class_table[uint8_t(this->char_stream.peek())]){
+					break; case CharClass::Unrecognized:              return false;
+					break; case CharClass::Whitespace:                return this->tokenize_whitespace();
+					break; case CharClass::Slash:
+						return this->tokenize_comment() || this->tokenize_operator();
+					break; case CharClass::IdentifierStart:           return this->tokenize_identifier();
+					break; case CharClass::IntrinsicOrAttributeStart: return this->tokenize_identifier();
+					break; case CharClass::Operator:                  return this->tokenize_operator();
+					break; case CharClass::Number:                    return this->tokenize_number_literal();
+					break; case CharClass::TextDelimiter:             return this->tokenize_string_literal();
+				};
+
+				evo::debugFatalBreak("Unknown or unsupported char class");
+			}();
+
+			if(consumed_source){
+				// some errors are reported without consuming anything, which would loop forever if the fail condition
+				// 		wasn't hit (`maxNumErrors` > 1)
+				if(this->char_stream.get_offset() == this->current_token_start){ return false; }
+				continue;
+			}
 			
 			this->error_unrecognized_character();
-			return evo::resultError;
+			return false;
 		};
 
-		return std::move(this->token_buffer);
+		return true;
+	};
+
+
+
+	auto Tokenizer::findChunkStarts(std::string_view data, size_t target_chunk_size) noexcept
+	-> std::vector<uint32_t> {
+		evo::debugAssert(target_chunk_size != 0, "Target chunk size cannot be 0");
+
+		auto chunk_starts = std::vector<uint32_t>{0};
+		size_t next_target = target_chunk_size;
+
+		// Only comments and text literals can contain a newline, and they can only start with '/', '"', or '\''.
+		// 		Skipping them follows the same rules as the rest of the Tokenizer. Anything that's an error gets
+		// 		tokenized (and reported) by whichever chunk it lands in.
+		size_t cursor = 0;
+		while(cursor < data.size()){
+			const size_t next_special = cursor + char_scanning::findFirstOf(data.substr(cursor), '/', '"', '\'');
+
+			// split at newlines in [cursor, next_special)
+			while(next_target < next_special){
+				const size_t search_start = std::max(cursor, next_target);
+				const size_t newline = search_start + char_scanning::findFirstOf(
+					data.substr(search_start, next_special - search_start), '\n', '\r'
+				);
+				if(newline >= next_special){ break; }
+
+				chunk_starts.emplace_back(uint32_t(newline + 1));
+				next_target = newline + 1 + target_chunk_size;
+			};
+
+			if(next_special >= data.size()){ break; }
+			cursor = next_special;
+
+			if(data[cursor] == '/'){
+				if(cursor + 1 < data.size() && data[cursor + 1] == '/'){ // line comment
+					cursor += 2;
+					cursor += char_scanning::findFirstOf(data.substr(cursor), '\n', '\r');
+
+				}else if(cursor + 1 < data.size() && data[cursor + 1] == '*'){ // multi-line comment
+					cursor += 2;
+
+					unsigned num_closes_needed = 1;
+					while(num_closes_needed > 0){
+						cursor += char_scanning::findFirstOf(data.substr(cursor), '/', '*');
+
+						if(data.size() - cursor < 2){ return chunk_starts; } // unterminated
+
+						if(data[cursor] == '/' && data[cursor + 1] == '*'){
+							cursor += 2;
+							num_closes_needed += 1;
+
+						}else if(data[cursor] == '*' && data[cursor + 1] == '/'){
+							cursor += 2;
+							num_closes_needed -= 1;
+
+						}else{
+							cursor += 1;
+						}
+					};
+
+				}else{
+					cursor += 1;
+				}
+
+			}else{ // text literal
+				const char delimiter = data[cursor];
+				cursor += 1;
+
+				while(true){
+					cursor += char_scanning::findFirstOf(data.substr(cursor), delimiter, '\\');
+
+					if(cursor >= data.size()){ return chunk_starts; } // unterminated
+
+					if(data[cursor] == delimiter){
+						cursor += 1;
+						break;
+					}
+
+					if(data.size() - cursor < 2){ return chunk_starts; } // unterminated
+					cursor += 2;
+				};
+			}
+		};
+
+		return chunk_starts;
 	};
 
 
 
 	auto Tokenizer::tokenize_whitespace() noexcept -> bool {
 		if(evo::isWhitespace(this->char_stream.peek())){
-			this->char_stream.skip(1);
+			this->char_stream.skip_whitespace();
 			return true;
 		}
 		return false;
@@ -50,13 +272,7 @@ namespace pcit::panther{
 
 		if(this->char_stream.peek(1) == '/'){ // line comment
 			this->char_stream.skip(2);
-
-			while(
-				this->char_stream.at_end() == false && 
-				this->char_stream.peek() != '\n' && this->char_stream.peek() != '\r'
-			){
-				this->char_stream.skip(1);
-			};
+			this->char_stream.skip_until_either('\n', '\r');
 
 			return true;
 
@@ -65,14 +281,13 @@ namespace pcit::panther{
 
 			unsigned num_closes_needed = 1;
 			while(num_closes_needed > 0){
+				// only a '/' or '*' can start a "/*" or "*/"
+				this->char_stream.skip_until_either('/', '*');
+
 				if(this->char_stream.ammount_left() < 2){
-					this->context.emitError(
+					this->emit_error(
 						Diagnostic::Code::TokUnterminatedMultilineComment,
-						Source::Location(
-							this->source_id,
-							this->current_token_line_start, this->char_stream.get_line(),
-							this->current_token_collumn_start, this->char_stream.get_collumn()
-						),
+						this->get_source_location(this->current_token_start, this->char_stream.get_offset()),
 						"Unterminated multi-line comment",
 						std::vector<Diagnostic::Info>{
 							Diagnostic::Info("Expected a \"*/\" before the end of the file"),
@@ -104,20 +319,91 @@ namespace pcit::panther{
 
 
 
-	const static auto keyword_map = std::unordered_map<std::string_view, Token::Kind>{
-		// types
-		{"Void", Token::Kind::TypeVoid},
-		{"Type", Token::Kind::TypeType},
+	// Keywords are grouped by their length and first character, so an identifier is only compared to the few
+	// 		keywords it could be (most identifiers aren't compared to any)
+	struct KeywordTable{
+		static constexpr size_t MAX_KEYWORD_LENGTH = [](){
+			size_t max_length = 0;
+			for(const Token::KindSpec& spec : Token::KIND_SPECS){
+				if(spec.category == Token::SpellingCategory::Keyword){
+					max_length = std::max(max_length, spec.spelling.size());
+				}
+			}
+			return max_length;
+		}();
+
+		static constexpr size_t NUM_KEYWORDS = std::ranges::count(
+			Token::KIND_SPECS, Token::SpellingCategory::Keyword, &Token::KindSpec::category
+		);
 
-		// keywords
-		{"func", Token::Kind::KeywordFunc},
+		struct Bucket{
+			uint8_t begin = 0;
+			uint8_t end = 0;
+		};
+
+		std::array<Token::KindSpec, NUM_KEYWORDS> keywords{}; // sorted by bucket
+		std::array<std::array<Bucket, 128>, MAX_KEYWORD_LENGTH + 1> buckets{}; // [length][first character]
 	};
 
+	static constexpr auto keyword_table = [](){
+		auto table = KeywordTable();
+		static_assert(KeywordTable::NUM_KEYWORDS <= std::numeric_limits<uint8_t>::max(), "Too many keywords");
+
+		size_t num_keywords = 0;
+		for(size_t length = 1; length <= KeywordTable::MAX_KEYWORD_LENGTH; length+=1){
+			for(size_t first_char = 0; first_char < 128; first_char+=1){
+				KeywordTable::Bucket& bucket = table.buckets[length][first_char];
+				bucket.begin = uint8_t(num_keywords);
+
+				for(const Token::KindSpec& spec : Token::KIND_SPECS){
+					if(
+						spec.category == Token::SpellingCategory::Keyword
+						&& spec.spelling.size() == length
+						&& size_t(spec.spelling[0]) == first_char
+					){
+						table.keywords[num_keywords] = spec;
+						num_keywords += 1;
+					}
+				}
+
+				bucket.end = uint8_t(num_keywords);
+			}
+		}
+
+		return table;
+	}();
+
+
+	// returns Token::Kind::None if `ident_name` isn't a keyword
+	// 	(`true` and `false` give Token::Kind::LiteralBool)
+	EVO_NODISCARD static constexpr auto lookup_keyword(std::string_view ident_name) noexcept -> Token::Kind {
+		if(ident_name.size() > KeywordTable::MAX_KEYWORD_LENGTH){ return Token::Kind::None; }
+
+		// identifiers are always ASCII
+		const KeywordTable::Bucket& bucket = keyword_table.buckets[ident_name.size()][uint8_t(ident_name[0])];
+
+		for(uint8_t i = bucket.begin; i < bucket.end; i+=1){
+			if(keyword_table.keywords[i].spelling == ident_name){ return keyword_table.keywords[i].kind; }
+		}
+
+		return Token::Kind::None;
+	};
+
+	static_assert(
+		std::ranges::all_of(
+			Token::KIND_SPECS,
+			[](const Token::KindSpec& spec){
+				return spec.category != Token::SpellingCategory::Keyword || lookup_keyword(spec.spelling) == spec.kind;
+			}
+		),
+		"`keyword_table` doesn't match `Token::KIND_SPECS`"
+	);
+
 
 	auto Tokenizer::tokenize_identifier() noexcept -> bool {
 		auto kind = Token::Kind::None;
 
-		char peeked_char = this->char_stream.peek();
+		const char peeked_char = this->char_stream.peek();
 		if(evo::isLetter(peeked_char) || peeked_char == '_'){
 			kind = Token::Kind::Ident;
 
@@ -143,96 +429,166 @@ namespace pcit::panther{
 
 		const char* string_start_ptr = this->char_stream.peek_raw_ptr();
 
-		std::string_view::size_type token_length = 0;
-
-		do{
-			this->char_stream.skip(1);
-			token_length += 1;
-
-			if(this->char_stream.at_end()){ break; }
-
-			peeked_char = this->char_stream.peek();
-		}while( (evo::isAlphaNumeric(peeked_char) || peeked_char == '_'));
+		this->char_stream.skip(1);
+		this->char_stream.skip_identifier_chars();
 
-		auto ident_name = std::string_view(string_start_ptr, token_length);
+		auto ident_name = std::string_view(string_start_ptr, this->char_stream.cursor_raw_ptr());
 
 		if(kind == Token::Kind::Ident){
-			if(ident_name == "true"){  this->create_token(Token::Kind::LiteralBool, true);  }
-			if(ident_name == "false"){ this->create_token(Token::Kind::LiteralBool, false); }
+			const Token::Kind keyword_kind = lookup_keyword(ident_name);
 
-			const auto keyword_map_iter = keyword_map.find(ident_name);
+			if(keyword_kind == Token::Kind::None){
+				this->create_token(Token::Ident, ident_name);
+
+			}else if(keyword_kind == Token::Kind::LiteralBool){
+				this->create_token(Token::Kind::LiteralBool, ident_name == "true");
 
-			if(keyword_map_iter == keyword_map.end()){
-				this->create_token(Token::Ident, std::string(ident_name));
 			}else{
-				this->create_token(keyword_map_iter->second);
+				this->create_token(keyword_kind);
 			}
 
 		}else{
-			this->create_token(kind, std::string(ident_name));
+			this->create_token(kind, ident_name);
 		}
 		
 
 		return true;
 	};
 
-	auto Tokenizer::tokenize_punctuation() noexcept -> bool {
-		const char peeked_char = this->char_stream.peek();
-		Token::Kind tok_kind = Token::None;
+	// Trie of the spellings of all of the operators (and punctuation). Characters are mapped to a dense index first
+	// 		so each node only needs a child for each character that's used by an operator.
+	struct OperatorTrie{
+		static constexpr uint8_t NOT_OPERATOR_CHAR = std::numeric_limits<uint8_t>::max();
+		static constexpr uint16_t NO_NODE = 0; // the root can't be a child
+
+		static constexpr size_t NUM_CHARS = [](){
+			auto is_used = std::array<bool, 256>();
+			for(const Token::KindSpec& spec : Token::KIND_SPECS){
+				if(spec.category != Token::SpellingCategory::Operator){ continue; }
+				for(const char c : spec.spelling){ is_used[uint8_t(c)] = true; }
+			}
+			return size_t(std::ranges::count(is_used, true));
+		}();
+
+		// upper bound (operators that share a prefix share nodes)
+		static constexpr size_t MAX_NUM_NODES = [](){
+			size_t num_nodes = 1;
+			for(const Token::KindSpec& spec : Token::KIND_SPECS){
+				if(spec.category == Token::SpellingCategory::Operator){ num_nodes += spec.spelling.size(); }
+			}
+			return num_nodes;
+		}();
 
-		switch(peeked_char){
-			break; case '(': tok_kind = Token::OpenParen;
-			break; case ')': tok_kind = Token::CloseParen;
-			break; case '[': tok_kind = Token::OpenBracket;
-			break; case ']': tok_kind = Token::CloseBracket;
-			break; case '{': tok_kind = Token::OpenBrace;
-			break; case '}': tok_kind = Token::CloseBrace;
+		struct Node{
+			Token::Kind kind = Token::Kind::None; // the operator that ends at this node (if any)
+			std::array<uint16_t, NUM_CHARS> children{};
+		};
 
-			break; case ',': tok_kind = Token::Comma;
-			break; case ';': tok_kind = Token::SemiColon;
-			break; case ':': tok_kind = Token::Colon;
+		std::array<uint8_t, 256> char_indices{};
+		std::array<Node, MAX_NUM_NODES> nodes{};
+	};
 
-			break; case '|': tok_kind = Token::Pipe;
-		};
+	static constexpr auto operator_trie = [](){
+		auto trie = OperatorTrie();
+		static_assert(OperatorTrie::MAX_NUM_NODES <= std::numeric_limits<uint16_t>::max(), "Too many operators");
+		static_assert(OperatorTrie::NUM_CHARS < OperatorTrie::NOT_OPERATOR_CHAR, "Too many operator characters");
 
-		if(tok_kind == Token::None){ return false; }
+		trie.char_indices.fill(OperatorTrie::NOT_OPERATOR_CHAR);
+		uint8_t num_chars = 0;
+		size_t num_nodes = 1;
 
-		this->char_stream.skip(1);
+		for(const Token::KindSpec& spec : Token::KIND_SPECS){
+			if(spec.category != Token::SpellingCategory::Operator){ continue; }
 
-		this->create_token(tok_kind);
+			size_t node = 0;
+			for(const char c : spec.spelling){
+				uint8_t& char_index = trie.char_indices[uint8_t(c)];
+				if(char_index == OperatorTrie::NOT_OPERATOR_CHAR){
+					char_index = num_chars;
+					num_chars += 1;
+				}
 
-		return true;
-	};
+				uint16_t& child = trie.nodes[node].children[char_index];
+				if(child == OperatorTrie::NO_NODE){
+					child = uint16_t(num_nodes);
+					num_nodes += 1;
+				}
+				node = child;
+			}
+
+			trie.nodes[node].kind = spec.kind;
+		}
 
-	auto Tokenizer::tokenize_operators() noexcept -> bool {
-		auto is_op = [&](std::string_view op) noexcept -> bool {
-			if(this->char_stream.ammount_left() < op.size()){ return false; }
+		return trie;
+	}();
 
-			for(int i = 0; i < op.size(); i+=1){
-				if(this->char_stream.peek(i) != op[i]){
-					return false;
+	static_assert(
+		std::ranges::all_of(
+			Token::KIND_SPECS,
+			[](const Token::KindSpec& spec){
+				if(spec.category != Token::SpellingCategory::Operator){ return true; }
+
+				uint16_t node = 0;
+				for(const char c : spec.spelling){
+					node = operator_trie.nodes[node].children[operator_trie.char_indices[uint8_t(c)]];
 				}
+				return operator_trie.nodes[node].kind == spec.kind;
 			}
+		),
+		"`operator_trie` doesn't match `Token::KIND_SPECS`"
+	);
 
-			return true;
-		};
 
+	auto Tokenizer::tokenize_operator() noexcept -> bool {
+		// maximal munch (the longest operator that matches)
+		auto longest_match_kind = Token::Kind::None;
+		size_t longest_match_length = 0;
 
+		const size_t max_length = std::min(this->char_stream.ammount_left(), Token::MAX_OPERATOR_LENGTH);
 
-		auto set_op = [&](std::string_view op){
-			this->char_stream.skip(ptrdiff_t(op.size()));
-			this->create_token(Token::lookupKind(op.data()));
-		};
+		uint16_t node = 0;
+		for(size_t i = 0; i < max_length; i+=1){
+			const uint8_t char_index = operator_trie.char_indices[uint8_t(this->char_stream.peek(i))];
+			if(char_index == OperatorTrie::NOT_OPERATOR_CHAR){ break; }
 
-		// length 2
-		if(is_op("->")){ set_op("->"); return true; }
+			node = operator_trie.nodes[node].children[char_index];
+			if(node == OperatorTrie::NO_NODE){ break; }
 
+			if(operator_trie.nodes[node].kind != Token::Kind::None){
+				longest_match_kind = operator_trie.nodes[node].kind;
+				longest_match_length = i + 1;
+			}
+		}
 
-		// length 1
-		if(is_op("=")){ set_op("="); return true; }
+		if(longest_match_kind == Token::Kind::None){ return false; }
 
+		this->char_stream.skip(longest_match_length);
+		this->create_token(longest_match_kind);
 
-		return false;
+		return true;
+	};
+
+
+	// Literals that are small enough that they can't be too large can be created without their value, as the check
+	// 		for being too large is the only one that needs it (see `Context::Config::lazyLiteralValues`).
+	// 	These are conservative (leading zeros are counted), so the few literals near the limits are decoded eagerly.
+
+	EVO_NODISCARD static constexpr auto int_literal_cannot_be_too_large(size_t num_digits, int base) noexcept -> bool {
+		switch(base){
+			case 2:  return num_digits <= 64;
+			case 8:  return num_digits <= 21;
+			case 10: return num_digits <= 19;
+			case 16: return num_digits <= 16;
+		};
+
+		evo::debugFatalBreak("Unknown base");
+	};
+
+	// `magnitude` is the number of digits before the decimal point plus the exponent
+	EVO_NODISCARD static constexpr auto float_literal_cannot_be_too_large(int64_t magnitude, int base) noexcept
+	-> bool {
+		if(base == 16){ return magnitude <= 250; } // 2^1000
+		return magnitude <= 300; // 10^300
 	};
 
 
@@ -259,9 +615,9 @@ namespace pcit::panther{
 				this->char_stream.skip(2);
 
 			}else if(evo::isNumber(second_peek)){
-				this->context.emitError(
+				this->emit_error(
 					Diagnostic::Code::TokLiteralLeadingZero,
-					Source::Location(this->source_id, this->char_stream.get_line(), this->char_stream.get_collumn()),
+					this->get_source_location(this->char_stream.get_offset()),
 					"Leading zeros in literal numbers are not supported",
 					std::vector<Diagnostic::Info>{
 						Diagnostic::Info("Note: the literal integer prefix for base-8 is \"0o\""),
@@ -274,11 +630,13 @@ namespace pcit::panther{
 
 
 		///////////////////////////////////
-		// get number
+		// get digits
+		// 	(parsed in place from the source, `digits_start` to `digits_end` includes digit separators)
 
-		auto number_string = std::string{};
+		const char* digits_start = this->char_stream.cursor_raw_ptr();
 
 		bool has_decimal_point = false;
+		const char* decimal_point_ptr = nullptr;
 
 		while(this->char_stream.at_end() == false){
 			const char peeked_char = this->char_stream.peek();
@@ -289,39 +647,33 @@ namespace pcit::panther{
 
 			}else if(peeked_char == '.'){
 				if(has_decimal_point){
-					this->context.emitError(
+					this->emit_error(
 						Diagnostic::Code::TokLiteralNumMultipleDecimalPoints,
-						Source::Location(
-							this->source_id, this->char_stream.get_line(), this->char_stream.get_collumn()
-						),
+						this->get_source_location(this->char_stream.get_offset()),
 						"Cannot have multiple decimal points in a floating-point literal"
 					);
 					return true;
 				}
 
 				if(base == 2){
-					this->context.emitError(
+					this->emit_error(
 						Diagnostic::Code::TokInvalidFPBase,
-						Source::Location(
-							this->source_id, this->current_token_line_start, this->current_token_collumn_start
-						),
+						this->get_source_location(this->current_token_start),
 						"Base-2 floating-point literals are not supported"
 					);
 					return true;
 
 				}else if(base == 8){
-					this->context.emitError(
+					this->emit_error(
 						Diagnostic::Code::TokInvalidFPBase,
-						Source::Location(
-							this->source_id, this->current_token_line_start, this->current_token_collumn_start
-						),
+						this->get_source_location(this->current_token_start),
 						"Base-8 floating-point literals are not supported"
 					);
 					return true;
 				}
 
 				has_decimal_point = true;
-				number_string += '.';
+				decimal_point_ptr = this->char_stream.cursor_raw_ptr();
 
 				this->char_stream.skip(1);
 				continue;
@@ -330,14 +682,12 @@ namespace pcit::panther{
 
 			if(base == 2){
 				if(peeked_char == '0' || peeked_char == '1'){
-					number_string += this->char_stream.next();
+					this->char_stream.skip(1);
 
 				}else if(evo::isHexNumber(peeked_char)){
-					this->context.emitError(
+					this->emit_error(
 						Diagnostic::Code::TokInvalidNumDigit,
-						Source::Location(
-							this->source_id, this->current_token_line_start, this->current_token_collumn_start
-						),
+						this->get_source_location(this->current_token_start),
 						"Base-2 numbers should only have digits 0 and 1"
 					);
 					return true;
@@ -348,14 +698,12 @@ namespace pcit::panther{
 
 			}else if(base == 8){
 				if(evo::isOctalNumber(peeked_char)){
-					number_string += this->char_stream.next();
+					this->char_stream.skip(1);
 
 				}else if(evo::isHexNumber(peeked_char)){
-					this->context.emitError(
+					this->emit_error(
 						Diagnostic::Code::TokInvalidNumDigit,
-						Source::Location(
-							this->source_id, this->current_token_line_start, this->current_token_collumn_start
-						),
+						this->get_source_location(this->current_token_start),
 						"Base-8 numbers should only have digits 0-7"
 					);
 					return true;
@@ -366,17 +714,15 @@ namespace pcit::panther{
 
 			}else if(base == 10){
 				if(evo::isNumber(peeked_char)){
-					number_string += this->char_stream.next();
+					this->char_stream.skip(1);
 
 				}else if(peeked_char == 'e' || peeked_char == 'E'){
 					break;
 
 				}else if(evo::isHexNumber(peeked_char)){
-					this->context.emitError(
+					this->emit_error(
 						Diagnostic::Code::TokInvalidNumDigit,
-						Source::Location(
-							this->source_id, this->current_token_line_start, this->current_token_collumn_start
-						),
+						this->get_source_location(this->current_token_start),
 						"Base-10 numbers should only have digits 0-9"
 					);
 					return true;
@@ -388,7 +734,7 @@ namespace pcit::panther{
 			}else{
 				// base-16
 				if(evo::isHexNumber(peeked_char)){
-					number_string += this->char_stream.next();
+					this->char_stream.skip(1);
 
 				}else{
 					break;
@@ -397,33 +743,58 @@ namespace pcit::panther{
 
 		};
 
+		const char* digits_end = this->char_stream.cursor_raw_ptr();
+
+		if(std::ranges::none_of(digits_start, digits_end, [](char c){ return c != '_' && c != '.'; })){
+			this->emit_error(
+				Diagnostic::Code::TokInvalidNumDigit,
+				this->get_source_location(this->current_token_start, this->char_stream.get_offset()),
+				"Literal number has no digits after the base prefix"
+			);
+			return true;
+		}
+
 
 		///////////////////////////////////
-		// get exponent (if it exsits)
+		// get exponent (if it exists)
+		// 	(saturates on overflow, which is still large enough to be caught as too large for anything but 0)
 
-		auto exponent_string = std::string{};
+		bool has_exponent = false;
+		bool exponent_is_negative = false;
+		uint64_t exponent = 0;
+
+		// an 'e' after the digits is always the start of the exponent (even at the end of the source), so whether a
+		// 		number ends before it only depends on that 1 character (see `MAX_LOOKAHEAD`)
 		if(
-			this->char_stream.ammount_left() >= 2 && 
-			(this->char_stream.peek() == 'e' || this->char_stream.peek() == 'E')
+			this->char_stream.at_end() == false
+			&& (this->char_stream.peek() == 'e' || this->char_stream.peek() == 'E')
 		){
+			has_exponent = true;
 			this->char_stream.skip(1);
 
-			if(this->char_stream.peek() == '-' || this->char_stream.peek() == '+'){
-				exponent_string += this->char_stream.next();
+			if(
+				this->char_stream.at_end() == false
+				&& (this->char_stream.peek() == '-' || this->char_stream.peek() == '+')
+			){
+				exponent_is_negative = this->char_stream.next() == '-';
 			}
 
+			bool has_exponent_digits = false;
+
 			while(this->char_stream.at_end() == false){
 				const char peeked_char = this->char_stream.peek();
 
 				if(evo::isNumber(peeked_char)){
-					exponent_string += this->char_stream.next();
+					has_exponent_digits = true;
+					exponent = std::min(
+						exponent * 10 + uint64_t(peeked_char - '0'), uint64_t(std::numeric_limits<uint32_t>::max())
+					);
+					this->char_stream.skip(1);
 
 				}else if(evo::isHexNumber(peeked_char)){
-					this->context.emitError(
+					this->emit_error(
 						Diagnostic::Code::TokInvalidNumDigit,
-						Source::Location(
-							this->source_id, this->char_stream.get_line(), this->char_stream.get_collumn()
-						),
+						this->get_source_location(this->char_stream.get_offset()),
 						"Literal number exponents should only have digits 0-9"
 					);
 					return true;
@@ -432,192 +803,112 @@ namespace pcit::panther{
 					break;
 				}
 			};
-		}
-
-
-
-		///////////////////////////////////
-		// parse exponent (if it exists)
-
-		int64_t exponent_number = 1;
-
-		if(exponent_string.size() != 0){
-			exponent_number = std::strtoll(exponent_string.data(), nullptr, base);
 
-			if(exponent_number == ULLONG_MAX && errno == ERANGE){
-				this->context.emitError(
-					Diagnostic::Code::TokLiteralNumTooBig,
-					Source::Location(
-						this->source_id,
-						this->current_token_line_start, this->char_stream.get_line(),
-						this->current_token_collumn_start, this->char_stream.get_collumn() - 1
-					),
-					"Literal number exponent too large to fit into a I64."
-					"This limitation will be removed when the compiler is self hosted."
+			if(has_exponent_digits == false){
+				this->emit_error(
+					Diagnostic::Code::TokInvalidNumDigit,
+					this->get_source_location(this->current_token_start, this->char_stream.get_offset()),
+					"Literal number exponent has no digits"
 				);
 				return true;
-
-			}else if(exponent_number == 0){
-				for(const char& character : exponent_string){
-					if(character != '0'){
-						this->context.emitFatal(
-							Diagnostic::Code::TokUnknownFailureToTokenizeNum,
-							Source::Location(
-								this->source_id,
-								this->current_token_line_start, this->char_stream.get_line(),
-								this->current_token_collumn_start, this->char_stream.get_collumn() - 1
-							),
-							"Tried to convert invalid integer string for exponent"
-						);
-						return true;
-					}
-				}
-			}
-		}
-
-
-		///////////////////////////////////
-		// check exponent isn't too large
-
-		if(exponent_number != 0 && exponent_number != 1){
-			const float64_t floating_point_exponent_number = float64_t(exponent_number);
-
-			if(has_decimal_point){
-				const static float64_t max_float_exp = std::log10(std::numeric_limits<float64_t>::max()) + 1;
-
-				if(floating_point_exponent_number > max_float_exp){
-					this->context.emitError(
-						Diagnostic::Code::TokLiteralNumTooBig,
-						Source::Location(
-							this->source_id,
-							this->current_token_line_start, this->char_stream.get_line(),
-							this->current_token_collumn_start, this->char_stream.get_collumn() - 1
-						),
-						"Literal floating-point number too large to fit into an F64"
-					);
-					return true;
-				}
-
-			}else{
-				const static float64_t max_int_exp = std::log10(std::numeric_limits<uint64_t>::max()) + 1;
-
-				if(floating_point_exponent_number > max_int_exp){
-					this->context.emitError(
-						Diagnostic::Code::TokLiteralNumTooBig,
-						Source::Location(
-							this->source_id,
-							this->current_token_line_start, this->char_stream.get_line(),
-							this->current_token_collumn_start, this->char_stream.get_collumn() - 1
-						),
-						"Literal number integer too large to fit into a UI64. "
-						"This limitation will be removed when the compiler is self hosted."
-					);
-					return true;
-				}
 			}
 		}
 
 
 
 		///////////////////////////////////
-		// parse / save number (with some checking)
+		// parse / save number
 
 		if(has_decimal_point){
-			if(base == 16){
-				number_string = "0x" + number_string;
+			if(this->can_defer_literal_decoding()){
+				int64_t magnitude = std::ranges::count_if(
+					digits_start, decimal_point_ptr, [](char c){ return c != '_'; }
+				);
+				magnitude += exponent_is_negative ? -int64_t(exponent) : int64_t(exponent);
+
+				if(float_literal_cannot_be_too_large(magnitude, base)){
+					this->create_lazy_literal_token(Token::Kind::LiteralFloat, this->get_current_token_str());
+					return true;
+				}
 			}
 
-			char* str_end;
-			const float64_t parsed_number = std::strtod(number_string.data(), &str_end);
+			const literal_decoding::DecodedFloat decoded_float = literal_decoding::decodeFloat(
+				literal_decoding::NumberLiteral(
+					std::string_view(digits_start, this->char_stream.cursor_raw_ptr()),
+					base,
+					exponent_is_negative,
+					exponent
+				)
+			);
 
-			if(parsed_number == HUGE_VALL){
-				this->context.emitError(
+			if(decoded_float.ec == std::errc::result_out_of_range){
+				this->emit_error(
 					Diagnostic::Code::TokLiteralNumTooBig,
-					Source::Location(
-						this->source_id,
-						this->current_token_line_start, this->char_stream.get_line(),
-						this->current_token_collumn_start, this->char_stream.get_collumn() - 1
-					),
+					this->get_source_location(this->current_token_start, this->char_stream.get_offset() - 1),
 					"Literal floating-point too large to fit into an F64"
 				);
 				return true;
 
-			}else if(parsed_number == 0.0L && str_end == number_string.data()){
-				this->context.emitFatal(
+			}else if(decoded_float.ec != std::errc()){
+				this->emit_fatal(
 					Diagnostic::Code::TokUnknownFailureToTokenizeNum,
-					Source::Location(
-						this->source_id,
-						this->current_token_line_start, this->char_stream.get_line(),
-						this->current_token_collumn_start, this->char_stream.get_collumn() - 1
-					),
+					this->get_source_location(this->current_token_start, this->char_stream.get_offset() - 1),
 					"Tried to convert invalid literal floating-point number"
 				);
 				return true;
 			}
 
-			if(
-				parsed_number == 0.0 && 
-				std::numeric_limits<float64_t>::max() / parsed_number < std::pow(10, exponent_number)
-			){
-				this->context.emitError(
-					Diagnostic::Code::TokLiteralNumTooBig,
-					Source::Location(
-						this->source_id,
-						this->current_token_line_start, this->char_stream.get_line(),
-						this->current_token_collumn_start, this->char_stream.get_collumn() - 1
-					),
-					"Literal number integer too large to fit into an F64."
-				);
-				return true;
-			}
+			this->create_token(Token::Kind::LiteralFloat, decoded_float.value);
 
 
-			float64_t output_number = parsed_number;
-			     if(exponent_number == 0){ output_number = 0; }
-			else if(exponent_number != 1){ output_number *= std::pow(10, exponent_number); }
-
-			this->create_token(Token::Kind::LiteralFloat, output_number);
+		}else{
+			const auto digits = std::string_view(digits_start, digits_end);
 
+			if(this->can_defer_literal_decoding() && exponent == 0){
+				const size_t num_digits = size_t(std::ranges::count_if(digits, [](char c){ return c != '_'; }));
 
-		}else{
-			const uint64_t parsed_number = std::strtoull(number_string.data(), nullptr, base);
+				if(int_literal_cannot_be_too_large(num_digits, base)){
+					this->create_lazy_literal_token(Token::Kind::LiteralInt, this->get_current_token_str());
+					return true;
+				}
+			}
 
-			if(parsed_number == ULLONG_MAX && errno == ERANGE){
-				this->context.emitError(
+			auto emit_too_big_error = [&]() noexcept -> void {
+				this->emit_error(
 					Diagnostic::Code::TokLiteralNumTooBig,
-					Source::Location(
-						this->source_id,
-						this->current_token_line_start, this->char_stream.get_line(),
-						this->current_token_collumn_start, this->char_stream.get_collumn() - 1
-					),
+					this->get_source_location(this->current_token_start, this->char_stream.get_offset() - 1),
 					"Literal integer too large to fit into a UI64. "
 					"This limitation will be removed when the compiler is self hosted."
 				);
-				return true;
+			};
 
-			}else if(parsed_number == 0){
-				for(const char& character : number_string){
-					if(character != '0'){
-						this->context.emitFatal(
-							Diagnostic::Code::TokUnknownFailureToTokenizeNum,
-							Source::Location(
-								this->source_id,
-								this->current_token_line_start, this->char_stream.get_line(),
-								this->current_token_collumn_start, this->char_stream.get_collumn() - 1
-							),
-							"Tried to convert invalid literal integer"
-						);
-						return true;
-					}
-				}
+			std::optional<uint64_t> parsed_number = literal_decoding::decodeIntDigits(digits, base);
+			if(parsed_number.has_value() == false){
+				emit_too_big_error();
+				return true;
 			}
 
+			if(has_exponent && exponent != 0){
+				if(exponent_is_negative){
+					this->emit_error(
+						Diagnostic::Code::TokLiteralIntNegativeExponent,
+						this->get_source_location(this->current_token_start, this->char_stream.get_offset() - 1),
+						"Literal integers cannot have a negative exponent",
+						std::vector<Diagnostic::Info>{
+							Diagnostic::Info("Note: add a decimal point to make it a floating-point literal"),
+						}
+					);
+					return true;
+				}
 
-			uint64_t output_number = parsed_number;
-			     if(exponent_number == 0){ output_number = 0; }
-			else if(exponent_number != 1){ output_number *= uint64_t(std::pow(10, exponent_number)); }
+				parsed_number = literal_decoding::applyIntExponent(*parsed_number, exponent);
+				if(parsed_number.has_value() == false){
+					emit_too_big_error();
+					return true;
+				}
+			}
 
-			this->create_token(Token::Kind::LiteralInt, output_number);
+			this->create_token(Token::Kind::LiteralInt, *parsed_number);
 		}
 
 		return true;
@@ -629,47 +920,57 @@ namespace pcit::panther{
 
 		const char delimiter = this->char_stream.next();
 
+		// Literals without escape sequences are a view directly into the source
+		// 		(only literals with escape sequences are copied into `literal_value`, unless decoding is deferred)
+		const char* literal_start_ptr = this->char_stream.cursor_raw_ptr();
+		const bool should_decode = this->can_defer_literal_decoding() == false;
+		bool has_escape_sequence = false;
 		auto literal_value = std::string();
 
-		while(this->char_stream.peek() != delimiter){
+		while(this->char_stream.at_end() || this->char_stream.peek() != delimiter){
 			bool unexpected_at_end = false;
 
 			if(this->char_stream.at_end()){
 				unexpected_at_end = true;
 
 			}else if(this->char_stream.peek() == '\\'){
-				switch(this->char_stream.peek(1)){
-					break; case '0': literal_value += '\0';
-					break; case 'a': literal_value += '\a';
-					break; case 'b': literal_value += '\b';
-					break; case 't': literal_value += '\t';
-					break; case 'n': literal_value += '\n';
-					break; case 'v': literal_value += '\v';
-					break; case 'f': literal_value += '\f';
-					break; case 'r': literal_value += '\r';
-
-					break; case '\'': literal_value += '\'';
-					break; case '"':  literal_value += '"';
-					break; case '\\': literal_value += '\\';
-
-					break; default: {
-						this->context.emitError(
+				if(this->char_stream.ammount_left() < 2){
+					unexpected_at_end = true;
+
+				}else{
+					if(has_escape_sequence == false){
+						has_escape_sequence = true;
+						if(should_decode){
+							literal_value = std::string(literal_start_ptr, this->char_stream.cursor_raw_ptr());
+						}
+					}
+
+					const std::optional<char> escaped_char =
+						literal_decoding::decodeEscapeSequence(this->char_stream.peek(1));
+
+					if(escaped_char.has_value() == false){
+						this->emit_error(
 							Diagnostic::Code::TokUnterminatedTextEscapeSequence,
-							Source::Location(
-								this->source_id,
-								this->char_stream.get_line(), this->char_stream.get_line(),
-								this->char_stream.get_collumn(), this->char_stream.get_collumn() + 1
+							this->get_source_location(
+								this->char_stream.get_offset(), this->char_stream.get_offset() + 1
 							),
 							std::format("Unknown string escape code '\\{}'", this->char_stream.peek(1))
 						);
 						return true;
 					}
-				};
 
-				this->char_stream.skip(2);
+					if(should_decode){ literal_value += *escaped_char; }
+
+					this->char_stream.skip(2);
+				}
 
 			}else{
-				literal_value += this->char_stream.next();
+				const char* run_start_ptr = this->char_stream.cursor_raw_ptr();
+				this->char_stream.skip_until_either(delimiter, '\\');
+
+				if(has_escape_sequence && should_decode){
+					literal_value.append(run_start_ptr, this->char_stream.cursor_raw_ptr());
+				}
 			}
 
 			// needed because some code above may have called next() or skip()
@@ -684,13 +985,9 @@ namespace pcit::panther{
 					evo::debugFatalBreak("Unknown delimiter");
 				}();
 
-				this->context.emitError(
+				this->emit_error(
 					Diagnostic::Code::TokUnterminatedMultilineComment,
-					Source::Location(
-						this->source_id,
-						this->current_token_line_start, this->char_stream.get_line(),
-						this->current_token_collumn_start, this->char_stream.get_collumn()
-					),
+					this->get_source_location(this->current_token_start, this->char_stream.get_offset()),
 					std::format("Unterminated {} literal", string_type_name),
 					std::vector<Diagnostic::Info>{
 						Diagnostic::Info(std::format("Expected a {} before the end of the file", delimiter)),
@@ -702,12 +999,19 @@ namespace pcit::panther{
 		};
 
 
+		const Token::Kind kind = delimiter == '\'' ? Token::Kind::LiteralChar : Token::Kind::LiteralString;
+		const auto literal_str = std::string_view(literal_start_ptr, this->char_stream.cursor_raw_ptr());
+
 		this->char_stream.skip(1);
 
-		if(delimiter == '\''){
-			this->create_token(Token::LiteralChar, std::move(literal_value));
+		if(has_escape_sequence == false){
+			this->create_token(kind, literal_str);
+
+		}else if(should_decode){
+			this->create_token(kind, this->context.getStringInterner().intern(literal_value));
+
 		}else{
-			this->create_token(Token::LiteralString, std::move(literal_value));
+			this->create_lazy_literal_token(kind, literal_str);
 		}
 
 
@@ -719,31 +1023,57 @@ namespace pcit::panther{
 	// create tokens
 
 	auto Tokenizer::create_token(Token::Kind kind) noexcept -> void {
-		this->token_buffer.createToken(
-			kind,
-			Token::Location(
-				this->current_token_line_start,
-				this->char_stream.get_line(),
-				this->current_token_collumn_start,
-				this->char_stream.get_collumn()
-			)
+		const auto location = Token::Location(
+			this->current_token_start, this->char_stream.get_offset() - this->current_token_start
 		);
+
+		if(this->is_streaming){
+			this->streamed_token.emplace(kind, location);
+		}else{
+			this->token_buffer.createToken(kind, location);
+		}
 	};
 
 
 	auto Tokenizer::create_token(Token::Kind kind, auto&& val) noexcept -> void {
-		this->token_buffer.createToken(
+		const auto location = Token::Location(
+			this->current_token_start, this->char_stream.get_offset() - this->current_token_start
+		);
+
+		if(this->is_streaming){
+			this->streamed_token.emplace(kind, location, std::forward<decltype(val)>(val));
+		}else{
+			this->token_buffer.createToken(kind, location, std::forward<decltype(val)>(val));
+		}
+	};
+
+	auto Tokenizer::create_lazy_literal_token(Token::Kind kind, std::string_view raw_value) noexcept -> void {
+		evo::debugAssert(this->can_defer_literal_decoding(), "Cannot defer decoding of this literal");
+
+		this->token_buffer.createLazyLiteralToken(
 			kind,
-			Token::Location(
-				this->current_token_line_start,
-				this->char_stream.get_line(),
-				this->current_token_collumn_start,
-				this->char_stream.get_collumn()
-			),
-			std::forward<decltype(val)>(val)
+			Token::Location(this->current_token_start, this->char_stream.get_offset() - this->current_token_start),
+			raw_value,
+			this->context.getStringInterner()
 		);
 	};
 
+	auto Tokenizer::get_current_token_str() const noexcept -> std::string_view {
+		const uint32_t current_token_size = this->char_stream.get_offset() - this->current_token_start;
+		return std::string_view(this->char_stream.cursor_raw_ptr() - current_token_size, current_token_size);
+	};
+
+
+
+	auto Tokenizer::get_source_location(uint32_t offset) const noexcept -> Source::Location {
+		return this->context.getSourceManager().getSource(this->source_id).getLocation(offset);
+	};
+
+	auto Tokenizer::get_source_location(uint32_t start_offset, uint32_t end_offset) const noexcept
+	-> Source::Location {
+		return this->context.getSourceManager().getSource(this->source_id).getLocation(start_offset, end_offset);
+	};
+
 
 
 
@@ -777,13 +1107,9 @@ namespace pcit::panther{
 		const char peeked_char = this->char_stream.peek();
 
 		if(peeked_char >= 0){
-			this->context.emitError(
+			this->emit_error(
 				Diagnostic::Code::TokUnrecognizedCharacter,
-				Source::Location(
-					this->source_id,
-					this->char_stream.get_line(), this->char_stream.get_line(),
-					this->char_stream.get_collumn(), this->char_stream.get_collumn()
-				),
+				this->get_source_location(this->char_stream.get_offset()),
 				std::format(
 					"Unrecognized character \"{}\" (charcode: {})",
 					evo::printCharName(peeked_char),
@@ -802,13 +1128,9 @@ namespace pcit::panther{
 		const size_t num_chars_of_utf8 = std::countl_one(static_cast<unsigned char>(this->char_stream.peek()));
 
 		if(num_chars_of_utf8 > 4 || this->char_stream.ammount_left() < num_chars_of_utf8){
-			this->context.emitError(
+			this->emit_error(
 				Diagnostic::Code::TokUnrecognizedCharacter,
-				Source::Location(
-					this->source_id,
-					this->char_stream.get_line(), this->char_stream.get_line(),
-					this->char_stream.get_collumn(), this->char_stream.get_collumn()
-				),
+				this->get_source_location(this->char_stream.get_offset()),
 				std::format(
 					"Unrecognized character (non-standard utf-8 character)",
 					evo::printCharName(peeked_char),
@@ -886,9 +1208,9 @@ namespace pcit::panther{
 			} break;
 		};
 
-		this->context.emitError(
+		this->emit_error(
 			Diagnostic::Code::TokUnrecognizedCharacter,
-			Source::Location(this->source_id, this->char_stream.get_line(), this->char_stream.get_collumn()),
+			this->get_source_location(this->char_stream.get_offset()),
 			std::format("Unrecognized character \"{}\" (UTF-8 code: {})", utf8_str, utf8_charcodes_str)
 		);
 	};
@@ -22,45 +22,140 @@ namespace pcit::panther{
 
 	class Tokenizer{
 		public:
-			Tokenizer(Context& _context, Source::ID _source_id) noexcept
+			// Tokenizing stops early (and errors) once a stop is requested of `_stop_token`, which for a task is the
+			// 		stop token of its task group
+			Tokenizer(Context& _context, Source::ID _source_id, std::stop_token _stop_token = std::stop_token())
+				noexcept
 				: context(_context),
 				  source_id(_source_id),
-				  char_stream(this->context.getSourceManager().getSource(this->source_id).getData()) 
+				  stop_token(std::move(_stop_token)),
+				  char_stream(this->context.getSourceManager().getSource(this->source_id).getData()),
+				  lazy_literal_values(this->context.getConfig().lazyLiteralValues)
+				{};
+
+			// Only tokenizes [start_offset, end_offset) of the source (token locations are still from the start of the
+			// 		source). Offsets should be from `findChunkStarts()` (or `start_offset` the end of a token and
+			// 		`end_offset` the end of the source) so the tokens are the same as tokenizing the whole source.
+			Tokenizer(
+				Context& _context,
+				Source::ID _source_id,
+				uint32_t start_offset,
+				uint32_t end_offset,
+				std::stop_token _stop_token = std::stop_token()
+			) noexcept
+				: context(_context),
+				  source_id(_source_id),
+				  stop_token(std::move(_stop_token)),
+				  char_stream(
+					this->context.getSourceManager().getSource(this->source_id).getData().substr(0, end_offset),
+					start_offset
+				  ),
+				  lazy_literal_values(this->context.getConfig().lazyLiteralValues)
 				{};
 
 			~Tokenizer() = default;
 
+			// Each of these errors if this tokenizer emitted any errors (even if it didn't hit the fail condition), as
+			// 		the tokens after an error could be missing
 			EVO_NODISCARD auto tokenize() noexcept -> evo::Result<TokenBuffer>;
 
+			// Tokenizes just the next token (skipping any whitespace / comments before it), which is returned instead
+			// 		of being added to the token buffer. Returns nullopt at the end of the source.
+			// Used by `TokenStream` to tokenize a source without ever having all of its tokens in memory.
+			EVO_NODISCARD auto tokenizeNextToken() noexcept -> evo::Result<std::optional<Token>>;
+
+
+			// Tokenizing stops early if a stop was requested of the stop token (the task group was cancelled),
+			// 		which is only checked every this many tokens (and whitespace / comments) to keep it out of the hot
+			// 		loop.
+			static constexpr uint32_t CANCELLATION_CHECK_INTERVAL = 4096;
+
+			// The tokenizer never looks more than this many characters past the end of a token to decide what it is,
+			// 		so a token that ends at least this far before an edit is the same after the edit.
+			// 	(1 for comments / intrinsics / attributes / number prefixes and exponents, and an operator can be a
+			// 	 prefix of a longer one)
+			static constexpr uint32_t MAX_LOOKAHEAD = std::max(uint32_t(1), uint32_t(Token::MAX_OPERATOR_LENGTH - 1));
+
+			struct ResyncResult{
+				TokenBuffer tokenBuffer;
+				uint32_t resyncToken; // first of `old_tokens` that is the same (`old_tokens.size()` if none were)
+			};
+
+			// Used for incremental re-tokenization. Stops as soon as the next token would start at the same offset
+			// 		as one of `old_tokens` (from `first_resync_candidate` onwards), as every token from there on
+			// 		would be the same. The candidates must all be after the edited part of the source.
+			EVO_NODISCARD auto tokenizeUntilResync(const TokenBuffer& old_tokens, uint32_t first_resync_candidate)
+				noexcept -> evo::Result<ResyncResult>;
+
+			// Finds the offsets that a source can be split at to be tokenized in chunks (the first is always 0).
+			// Each split is just after a newline that isn't in a comment or a text literal, so no token can cross it,
+			// 		and chunks are at least `target_chunk_size` long (except for the last).
+			EVO_NODISCARD static auto findChunkStarts(std::string_view data, size_t target_chunk_size) noexcept
+				-> std::vector<uint32_t>;
+
 
 			EVO_NODISCARD auto getTokenBuffer() const noexcept -> const TokenBuffer& { return this->token_buffer; };
 
 			
 		private:
+			// returns false if it errored
+			// 	(`should_stop(offset)` is checked before each token / whitespace / comment)
+			EVO_NODISCARD auto tokenize_impl(auto&& should_stop) noexcept -> bool;
+
 			// these functions return true if they consumed any of the source file
 			EVO_NODISCARD auto tokenize_whitespace() noexcept -> bool;
 			EVO_NODISCARD auto tokenize_comment() noexcept -> bool;
 			EVO_NODISCARD auto tokenize_identifier() noexcept -> bool;
-			EVO_NODISCARD auto tokenize_punctuation() noexcept -> bool;
-			EVO_NODISCARD auto tokenize_operators() noexcept -> bool;
+			EVO_NODISCARD auto tokenize_operator() noexcept -> bool; // operators and punctuation
 			EVO_NODISCARD auto tokenize_number_literal() noexcept -> bool;
 			EVO_NODISCARD auto tokenize_string_literal() noexcept -> bool;
 
 			auto create_token(Token::Kind kind) noexcept -> void;
 			auto create_token(Token::Kind kind, auto&& value) noexcept -> void;
 
+			// the value is decoded by the TokenBuffer when it's first needed (see `Context::Config::lazyLiteralValues`)
+			auto create_lazy_literal_token(Token::Kind kind, std::string_view raw_value) noexcept -> void;
+			EVO_NODISCARD auto can_defer_literal_decoding() const noexcept -> bool {
+				return this->lazy_literal_values && this->is_streaming == false;
+			};
+
+			EVO_NODISCARD auto get_current_token_str() const noexcept -> std::string_view;
+
+			// Only used for diagnostics (resolving the line / collumn requires a lookup in the Source)
+			EVO_NODISCARD auto get_source_location(uint32_t offset) const noexcept -> Source::Location;
+			EVO_NODISCARD auto get_source_location(uint32_t start_offset, uint32_t end_offset) const noexcept
+				-> Source::Location;
+
 			
 			auto error_unrecognized_character() noexcept -> void;
+
+			// emits through the context and records that this tokenizer errored
+			// 	(the number of errors of the context can't be compared as other workers are also adding to it)
+			auto emit_error(auto&&... args) noexcept -> void {
+				this->emitted_error = true;
+				this->context.emitError(std::forward<decltype(args)>(args)...);
+			};
+
+			auto emit_fatal(auto&&... args) noexcept -> void {
+				this->emitted_error = true;
+				this->context.emitFatal(std::forward<decltype(args)>(args)...);
+			};
 	
 		private:
 			Context& context;
 			Source::ID source_id;
+			std::stop_token stop_token;
 
 			CharStream char_stream;
 			TokenBuffer token_buffer{};
+			bool lazy_literal_values;
+
+			// if set, created tokens go into `streamed_token` instead of `token_buffer` (see `tokenizeNextToken()`)
+			bool is_streaming = false;
+			std::optional<Token> streamed_token{};
 
-			uint32_t current_token_line_start;
-			uint32_t current_token_collumn_start;
+			uint32_t current_token_start;
+			bool emitted_error = false;
 	};
 
 
@@ -0,0 +1,340 @@
+//////////////////////////////////////////////////////////////////////
+//                                                                  //
+// Part of the PCIT-CPP, under the Apache License v2.0              //
+// You may not use this file except in compliance with the License. //
+// See `http://www.apache.org/licenses/LICENSE-2.0` for info        //
+//                                                                  //
+//////////////////////////////////////////////////////////////////////
+
+
+#include "./char_scanning.h"
+
+#include <bit>
+
+#if defined(__AVX2__)
+	#define PCIT_PANTHER_CHAR_SCANNING_AVX2
+	#include <immintrin.h>
+
+#elif defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define PCIT_PANTHER_CHAR_SCANNING_SSE2
+	#include <emmintrin.h>
+
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+	#define PCIT_PANTHER_CHAR_SCANNING_NEON
+	#include <arm_neon.h>
+#endif
+
+#if defined(PCIT_PANTHER_CHAR_SCANNING_AVX2) || defined(PCIT_PANTHER_CHAR_SCANNING_SSE2) \
+	|| defined(PCIT_PANTHER_CHAR_SCANNING_NEON)
+	#define PCIT_PANTHER_CHAR_SCANNING_HAS_VECTOR
+#endif
+
+
+namespace pcit::panther::char_scanning{
+
+	//////////////////////////////////////////////////////////////////////
+	// vector primitives
+	// 	Comparisons give 0xFF for each matching byte. `to_mask` packs them into an integer with
+	// 	`MASK_BITS_PER_CHAR` bits set per matching byte (NEON has no movemask so it uses 4 bits per byte).
+	// 	Range checks use signed compares, which is fine as every character they look for is ASCII
+	// 	(bytes >= 0x80 are negative and never in range).
+
+	#if defined(PCIT_PANTHER_CHAR_SCANNING_AVX2)
+
+		using Vector = __m256i;
+		static constexpr size_t VECTOR_SIZE = 32;
+		static constexpr size_t MASK_BITS_PER_CHAR = 1;
+
+		EVO_NODISCARD static auto load(const char* ptr) noexcept -> Vector {
+			return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr));
+		};
+		EVO_NODISCARD static auto splat(char c) noexcept -> Vector { return _mm256_set1_epi8(c); };
+		EVO_NODISCARD static auto equal(Vector lhs, Vector rhs) noexcept -> Vector {
+			return _mm256_cmpeq_epi8(lhs, rhs);
+		};
+		EVO_NODISCARD static auto greater(Vector lhs, Vector rhs) noexcept -> Vector {
+			return _mm256_cmpgt_epi8(lhs, rhs);
+		};
+		EVO_NODISCARD static auto bit_or(Vector lhs, Vector rhs) noexcept -> Vector {
+			return _mm256_or_si256(lhs, rhs);
+		};
+		EVO_NODISCARD static auto bit_and(Vector lhs, Vector rhs) noexcept -> Vector {
+			return _mm256_and_si256(lhs, rhs);
+		};
+		EVO_NODISCARD static auto to_mask(Vector vec) noexcept -> uint64_t {
+			return uint64_t(uint32_t(_mm256_movemask_epi8(vec)));
+		};
+
+	#elif defined(PCIT_PANTHER_CHAR_SCANNING_SSE2)
+
+		using Vector = __m128i;
+		static constexpr size_t VECTOR_SIZE = 16;
+		static constexpr size_t MASK_BITS_PER_CHAR = 1;
+
+		EVO_NODISCARD static auto load(const char* ptr) noexcept -> Vector {
+			return _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+		};
+		EVO_NODISCARD static auto splat(char c) noexcept -> Vector { return _mm_set1_epi8(c); };
+		EVO_NODISCARD static auto equal(Vector lhs, Vector rhs) noexcept -> Vector { return _mm_cmpeq_epi8(lhs, rhs); };
+		EVO_NODISCARD static auto greater(Vector lhs, Vector rhs) noexcept -> Vector {
+			return _mm_cmpgt_epi8(lhs, rhs);
+		};
+		EVO_NODISCARD static auto bit_or(Vector lhs, Vector rhs) noexcept -> Vector { return _mm_or_si128(lhs, rhs); };
+		EVO_NODISCARD static auto bit_and(Vector lhs, Vector rhs) noexcept -> Vector {
+			return _mm_and_si128(lhs, rhs);
+		};
+		EVO_NODISCARD static auto to_mask(Vector vec) noexcept -> uint64_t {
+			return uint64_t(uint32_t(_mm_movemask_epi8(vec)));
+		};
+
+	#elif defined(PCIT_PANTHER_CHAR_SCANNING_NEON)
+
+		using Vector = int8x16_t;
+		static constexpr size_t VECTOR_SIZE = 16;
+		static constexpr size_t MASK_BITS_PER_CHAR = 4;
+
+		EVO_NODISCARD static auto load(const char* ptr) noexcept -> Vector {
+			return vld1q_s8(reinterpret_cast<const int8_t*>(ptr));
+		};
+		EVO_NODISCARD static auto splat(char c) noexcept -> Vector { return vdupq_n_s8(int8_t(c)); };
+		EVO_NODISCARD static auto equal(Vector lhs, Vector rhs) noexcept -> Vector {
+			return vreinterpretq_s8_u8(vceqq_s8(lhs, rhs));
+		};
+		EVO_NODISCARD static auto greater(Vector lhs, Vector rhs) noexcept -> Vector {
+			return vreinterpretq_s8_u8(vcgtq_s8(lhs, rhs));
+		};
+		EVO_NODISCARD static auto bit_or(Vector lhs, Vector rhs) noexcept -> Vector { return vorrq_s8(lhs, rhs); };
+		EVO_NODISCARD static auto bit_and(Vector lhs, Vector rhs) noexcept -> Vector { return vandq_s8(lhs, rhs); };
+		EVO_NODISCARD static auto to_mask(Vector vec) noexcept -> uint64_t {
+			const uint8x8_t narrowed = vshrn_n_u16(vreinterpretq_u16_s8(vec), 4);
+			return vget_lane_u64(vreinterpret_u64_u8(narrowed), 0);
+		};
+
+	#endif
+
+
+	#if defined(PCIT_PANTHER_CHAR_SCANNING_HAS_VECTOR)
+
+		static constexpr uint64_t FULL_MASK = [](){
+			if constexpr(VECTOR_SIZE * MASK_BITS_PER_CHAR == 64){
+				return ~uint64_t(0);
+			}else{
+				return (uint64_t(1) << (VECTOR_SIZE * MASK_BITS_PER_CHAR)) - 1;
+			}
+		}();
+
+		EVO_NODISCARD static auto in_range(Vector vec, char min, char max) noexcept -> Vector {
+			return bit_and(greater(vec, splat(char(min - 1))), greater(splat(char(max + 1)), vec));
+		};
+
+		EVO_NODISCARD static auto is_whitespace(Vector vec) noexcept -> Vector {
+			// '\t', '\n', '\v', '\f', '\r' are contiguous
+			return bit_or(equal(vec, splat(' ')), in_range(vec, '\t', '\r'));
+		};
+
+		EVO_NODISCARD static auto is_identifier_char(Vector vec) noexcept -> Vector {
+			const Vector lowered = bit_or(vec, splat(0x20)); // 'A'-'Z' => 'a'-'z'
+
+			return bit_or(
+				bit_or(in_range(lowered, 'a', 'z'), in_range(vec, '0', '9')),
+				equal(vec, splat('_'))
+			);
+		};
+
+
+		// index of the first char where `is_match` is true (or false if `INVERT`), or `data.size()` if none
+		template<bool INVERT>
+		EVO_NODISCARD static auto find_first(std::string_view data, auto&& is_match, auto&& scalar_is_match) noexcept
+		-> size_t {
+			size_t i = 0;
+
+			for(; i + VECTOR_SIZE <= data.size(); i += VECTOR_SIZE){
+				uint64_t mask = to_mask(is_match(load(data.data() + i)));
+				if constexpr(INVERT){ mask ^= FULL_MASK; }
+
+				if(mask != 0){
+					return i + size_t(std::countr_zero(mask)) / MASK_BITS_PER_CHAR;
+				}
+			}
+
+			for(; i < data.size(); i+=1){
+				if(scalar_is_match(data[i]) != INVERT){ return i; }
+			}
+
+			return data.size();
+		};
+
+	#else
+
+		// `is_match` is unused (there's no vector implementation for this target)
+		template<bool INVERT>
+		EVO_NODISCARD static auto find_first(std::string_view data, auto&&, auto&& scalar_is_match) noexcept -> size_t {
+			for(size_t i = 0; i < data.size(); i+=1){
+				if(scalar_is_match(data[i]) != INVERT){ return i; }
+			}
+
+			return data.size();
+		};
+
+	#endif
+
+
+
+	//////////////////////////////////////////////////////////////////////
+	// kernels
+
+	auto findWhitespaceEnd(std::string_view data) noexcept -> size_t {
+		#if defined(PCIT_PANTHER_CHAR_SCANNING_HAS_VECTOR)
+			const auto vector_is_match = [](Vector vec) noexcept -> Vector { return is_whitespace(vec); };
+		#else
+			const auto vector_is_match = nullptr;
+		#endif
+
+		return find_first<true>(
+			data, vector_is_match, [](char c) noexcept -> bool { return evo::isWhitespace(c); }
+		);
+	};
+
+
+	auto findIdentifierEnd(std::string_view data) noexcept -> size_t {
+		#if defined(PCIT_PANTHER_CHAR_SCANNING_HAS_VECTOR)
+			const auto vector_is_match = [](Vector vec) noexcept -> Vector { return is_identifier_char(vec); };
+		#else
+			const auto vector_is_match = nullptr;
+		#endif
+
+		return find_first<true>(
+			data, vector_is_match, [](char c) noexcept -> bool { return evo::isAlphaNumeric(c) || c == '_'; }
+		);
+	};
+
+
+	auto findFirstOf(std::string_view data, char a, char b) noexcept -> size_t {
+		#if defined(PCIT_PANTHER_CHAR_SCANNING_HAS_VECTOR)
+			const Vector a_vec = splat(a);
+			const Vector b_vec = splat(b);
+			const auto vector_is_match = [&](Vector vec) noexcept -> Vector {
+				return bit_or(equal(vec, a_vec), equal(vec, b_vec));
+			};
+		#else
+			const auto vector_is_match = nullptr;
+		#endif
+
+		return find_first<false>(
+			data, vector_is_match, [&](char c) noexcept -> bool { return c == a || c == b; }
+		);
+	};
+
+	auto findFirstOf(std::string_view data, char a, char b, char c) noexcept -> size_t {
+		#if defined(PCIT_PANTHER_CHAR_SCANNING_HAS_VECTOR)
+			const Vector a_vec = splat(a);
+			const Vector b_vec = splat(b);
+			const Vector c_vec = splat(c);
+			const auto vector_is_match = [&](Vector vec) noexcept -> Vector {
+				return bit_or(bit_or(equal(vec, a_vec), equal(vec, b_vec)), equal(vec, c_vec));
+			};
+		#else
+			const auto vector_is_match = nullptr;
+		#endif
+
+		return find_first<false>(
+			data, vector_is_match, [&](char character) noexcept -> bool {
+				return character == a || character == b || character == c;
+			}
+		);
+	};
+
+
+	auto countNewlines(std::string_view data) noexcept -> size_t {
+		size_t num_newlines = 0;
+		size_t i = 0;
+
+		#if defined(PCIT_PANTHER_CHAR_SCANNING_HAS_VECTOR)
+			const Vector newline_vec = splat('\n');
+
+			for(; i + VECTOR_SIZE <= data.size(); i += VECTOR_SIZE){
+				const uint64_t mask = to_mask(equal(load(data.data() + i), newline_vec));
+				num_newlines += size_t(std::popcount(mask)) / MASK_BITS_PER_CHAR;
+			}
+		#endif
+
+		for(; i < data.size(); i+=1){
+			if(data[i] == '\n'){ num_newlines += 1; }
+		};
+
+		return num_newlines;
+	};
+
+
+	auto findFirstNonASCII(std::string_view data) noexcept -> size_t {
+		#if defined(PCIT_PANTHER_CHAR_SCANNING_HAS_VECTOR)
+			const Vector zero_vec = splat(0);
+			const auto vector_is_match = [&](Vector vec) noexcept -> Vector { return greater(zero_vec, vec); };
+		#else
+			const auto vector_is_match = nullptr;
+		#endif
+
+		return find_first<false>(
+			data, vector_is_match, [](char c) noexcept -> bool { return uint8_t(c) >= 0x80; }
+		);
+	};
+
+
+	// size of the UTF-8 sequence at the start of `data` (which must not start with ASCII), or 0 if it's not valid
+	EVO_NODISCARD static auto valid_utf8_sequence_size(std::string_view data) noexcept -> size_t {
+		const auto byte = [&](size_t i) noexcept -> uint8_t { return uint8_t(data[i]); };
+		const auto is_continuation = [&](size_t i) noexcept -> bool {
+			return i < data.size() && (byte(i) & 0xC0) == 0x80;
+		};
+
+		const uint8_t first = byte(0);
+
+		// the range of the second byte is narrower for some first bytes (to reject overlong encodings,
+		// 		surrogates, and code points above U+10FFFF)
+		uint8_t second_min = 0x80;
+		uint8_t second_max = 0xBF;
+		size_t size;
+
+		if(first >= 0xC2 && first <= 0xDF){
+			size = 2;
+
+		}else if(first >= 0xE0 && first <= 0xEF){
+			size = 3;
+			if(first == 0xE0){ second_min = 0xA0; }
+			if(first == 0xED){ second_max = 0x9F; }
+
+		}else if(first >= 0xF0 && first <= 0xF4){
+			size = 4;
+			if(first == 0xF0){ second_min = 0x90; }
+			if(first == 0xF4){ second_max = 0x8F; }
+
+		}else{
+			return 0; // continuation byte, overlong 2-byte sequence (0xC0, 0xC1), or above U+10FFFF
+		}
+
+		if(data.size() < 2 || byte(1) < second_min || byte(1) > second_max){ return 0; }
+
+		for(size_t i = 2; i < size; i+=1){
+			if(is_continuation(i) == false){ return 0; }
+		}
+
+		return size;
+	};
+
+
+	auto findInvalidUTF8(std::string_view data) noexcept -> size_t {
+		size_t i = findFirstNonASCII(data);
+
+		while(i < data.size()){
+			const size_t sequence_size = valid_utf8_sequence_size(data.substr(i));
+			if(sequence_size == 0){ return i; }
+
+			i += sequence_size;
+			i += findFirstNonASCII(data.substr(i));
+		};
+
+		return data.size();
+	};
+
+
+};
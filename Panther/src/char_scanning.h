@@ -0,0 +1,48 @@
+//////////////////////////////////////////////////////////////////////
+//                                                                  //
+// Part of the PCIT-CPP, under the Apache License v2.0              //
+// You may not use this file except in compliance with the License. //
+// See `http://www.apache.org/licenses/LICENSE-2.0` for info        //
+//                                                                  //
+//////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+
+#include <Evo.h>
+#include <PCIT_core.h>
+
+
+// Vectorized kernels used by the tokenizer to find the end of runs of characters many bytes at a time.
+// Uses AVX2 (if enabled for the build), SSE2, or NEON, and falls back to scalar code for other targets as well as
+// 		for the tail of the data (never reads past the end of the data, as it may be a memory-mapped file).
+// The `find` functions return `data.size()` if no such character was found.
+
+namespace pcit::panther::char_scanning{
+
+
+	// index of the first character that is not whitespace (as defined by `evo::isWhitespace`)
+	EVO_NODISCARD auto findWhitespaceEnd(std::string_view data) noexcept -> size_t;
+
+	// index of the first character that cannot continue an identifier (not a letter, number, or '_')
+	EVO_NODISCARD auto findIdentifierEnd(std::string_view data) noexcept -> size_t;
+
+	// index of the first character that is either `a` or `b`
+	EVO_NODISCARD auto findFirstOf(std::string_view data, char a, char b) noexcept -> size_t;
+
+	// index of the first character that is either `a`, `b`, or `c`
+	EVO_NODISCARD auto findFirstOf(std::string_view data, char a, char b, char c) noexcept -> size_t;
+
+	// number of '\n' characters
+	EVO_NODISCARD auto countNewlines(std::string_view data) noexcept -> size_t;
+
+	// index of the first byte that is not ASCII (>= 0x80)
+	EVO_NODISCARD auto findFirstNonASCII(std::string_view data) noexcept -> size_t;
+
+	// Index of the first byte of the first sequence that is not valid UTF-8 (RFC 3629, so overlong encodings,
+	// 		surrogates, and code points above U+10FFFF are invalid), including a sequence cut off by the end.
+	// Runs of ASCII are skipped with `findFirstNonASCII()`, so only multi-byte sequences are checked one at a time.
+	EVO_NODISCARD auto findInvalidUTF8(std::string_view data) noexcept -> size_t;
+
+};
@@ -34,26 +34,7 @@ namespace pcit::panther{
 		///////////////////////////////////
 		// find line in the source code
 
-		size_t cursor = 0;
-		size_t current_line = 1;
-		while(current_line < location.lineStart){
-			evo::debugAssert(
-				cursor < source.getData().size(), "out of bounds looking for line in source code for error"
-			);
-
-			if(source.getData()[cursor] == '\n'){
-				current_line += 1;
-
-			}else if(source.getData()[cursor] == '\r'){
-				current_line += 1;
-
-				if(source.getData()[cursor + 1] == '\n'){
-					cursor += 1;
-				}
-			}
-
-			cursor += 1;
-		};
+		size_t cursor = source.getLineStartOffset(location.lineStart);
 
 
 		///////////////////////////////////
@@ -63,7 +44,7 @@ namespace pcit::panther{
 		size_t point_collumn = location.collumnStart;
 		bool remove_whitespace = true;
 
-		while(source.getData()[cursor] != '\n' && source.getData()[cursor] != '\r' && cursor < source.getData().size()){
+		while(cursor < source.getData().size() && source.getData()[cursor] != '\n' && source.getData()[cursor] != '\r'){
 			if(remove_whitespace && (source.getData()[cursor] == '\t' || source.getData()[cursor] == ' ')){
 				// remove leading whitespace
 				point_collumn -= 1;
@@ -0,0 +1,117 @@
+//////////////////////////////////////////////////////////////////////
+//                                                                  //
+// Part of the PCIT-CPP, under the Apache License v2.0              //
+// You may not use this file except in compliance with the License. //
+// See `http://www.apache.org/licenses/LICENSE-2.0` for info        //
+//                                                                  //
+//////////////////////////////////////////////////////////////////////
+
+
+#include "./glob.h"
+
+namespace pcit::panther::glob{
+
+
+	auto hasWildcard(std::string_view str) noexcept -> bool {
+		return str.find_first_of("*?") != std::string_view::npos;
+	};
+
+
+	auto parse(const fs::path& pattern) noexcept -> Pattern {
+		auto output = Pattern();
+
+		for(const fs::path& component : pattern){
+			const std::string component_str = component.string();
+			if(component_str.empty()){ continue; } // trailing separator
+
+			if(output.components.empty() && hasWildcard(component_str) == false){
+				output.base /= component;
+			}else{
+				output.components.emplace_back(component_str);
+			}
+		}
+
+		return output;
+	};
+
+
+	EVO_NODISCARD static auto is_hidden(std::string_view str) noexcept -> bool {
+		return str.starts_with('.');
+	};
+
+
+	auto matchComponent(std::string_view pattern, std::string_view str) noexcept -> bool {
+		if(is_hidden(str) && is_hidden(pattern) == false){ return false; }
+
+		size_t pattern_i = 0;
+		size_t str_i = 0;
+
+		// where to go back to if the rest doesn't match (the last '*' matches one more character)
+		size_t star_pattern_i = std::string_view::npos;
+		size_t star_str_i = 0;
+
+		while(str_i < str.size()){
+			if(pattern_i < pattern.size() && pattern[pattern_i] == '*'){
+				star_pattern_i = pattern_i;
+				star_str_i = str_i;
+				pattern_i += 1;
+
+			}else if(pattern_i < pattern.size() && (pattern[pattern_i] == '?' || pattern[pattern_i] == str[str_i])){
+				pattern_i += 1;
+				str_i += 1;
+
+			}else if(star_pattern_i != std::string_view::npos){
+				pattern_i = star_pattern_i + 1;
+				star_str_i += 1;
+				str_i = star_str_i;
+
+			}else{
+				return false;
+			}
+		};
+
+		while(pattern_i < pattern.size() && pattern[pattern_i] == '*'){
+			pattern_i += 1;
+		};
+
+		return pattern_i == pattern.size();
+	};
+
+
+	auto match(std::span<const std::string> pattern_components, std::span<const std::string> path_components) noexcept
+	-> bool {
+		if(pattern_components.empty()){ return path_components.empty(); }
+
+		if(pattern_components[0] == "**"){
+			if(match(pattern_components.subspan(1), path_components)){ return true; }
+
+			return path_components.empty() == false
+				&& is_hidden(path_components[0]) == false
+				&& match(pattern_components, path_components.subspan(1));
+		}
+
+		return path_components.empty() == false
+			&& matchComponent(pattern_components[0], path_components[0])
+			&& match(pattern_components.subspan(1), path_components.subspan(1));
+	};
+
+
+	auto couldMatchInside(
+		std::span<const std::string> pattern_components, std::span<const std::string> directory_components
+	) noexcept -> bool {
+		if(directory_components.empty()){ return pattern_components.empty() == false; }
+		if(pattern_components.empty()){ return false; }
+
+		if(pattern_components[0] == "**"){
+			if(couldMatchInside(pattern_components.subspan(1), directory_components)){ return true; }
+
+			return is_hidden(directory_components[0]) == false
+				&& couldMatchInside(pattern_components, directory_components.subspan(1));
+		}
+
+		return matchComponent(pattern_components[0], directory_components[0])
+			&& couldMatchInside(pattern_components.subspan(1), directory_components.subspan(1));
+	};
+
+
+};
@@ -0,0 +1,55 @@
+//////////////////////////////////////////////////////////////////////
+//                                                                  //
+// Part of the PCIT-CPP, under the Apache License v2.0              //
+// You may not use this file except in compliance with the License. //
+// See `http://www.apache.org/licenses/LICENSE-2.0` for info        //
+//                                                                  //
+//////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+#include <filesystem>
+#include <span>
+namespace fs = std::filesystem;
+
+#include <Evo.h>
+#include <PCIT_core.h>
+
+
+// Matching of file paths against glob patterns (used by `Context` to find the files to load).
+// In each component of a pattern, `*` matches any number of characters and `?` matches any one character.
+// 		A component that is just `**` matches any number of directories (including none).
+// Paths are matched one component at a time (relative to the base of the pattern), so wildcards never match '/'.
+// Like in shells, names starting with '.' are only matched by a pattern component that also starts with '.'
+// 		(so hidden directories such as `.git` aren't searched by `**`).
+
+namespace pcit::panther::glob{
+
+
+	struct Pattern{
+		fs::path base; // every component before the first one with a wildcard (the directory to search from)
+		std::vector<std::string> components; // the rest of the pattern (empty if the pattern has no wildcards)
+	};
+
+	EVO_NODISCARD auto hasWildcard(std::string_view str) noexcept -> bool;
+
+	EVO_NODISCARD auto parse(const fs::path& pattern) noexcept -> Pattern;
+
+
+	// if a single component of a path matches a single component of a pattern (that isn't `**`)
+	EVO_NODISCARD auto matchComponent(std::string_view pattern, std::string_view str) noexcept -> bool;
+
+	// if a path (as components relative to the base of the pattern) matches the pattern
+	EVO_NODISCARD auto match(
+		std::span<const std::string> pattern_components, std::span<const std::string> path_components
+	) noexcept -> bool;
+
+	// if anything inside a directory (as components relative to the base of the pattern) could match the pattern
+	// 	(so directories that can't contain any matches aren't searched)
+	EVO_NODISCARD auto couldMatchInside(
+		std::span<const std::string> pattern_components, std::span<const std::string> directory_components
+	) noexcept -> bool;
+
+
+};
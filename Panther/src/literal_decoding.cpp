@@ -0,0 +1,206 @@
+//////////////////////////////////////////////////////////////////////
+//                                                                  //
+// Part of the PCIT-CPP, under the Apache License v2.0              //
+// You may not use this file except in compliance with the License. //
+// See `http://www.apache.org/licenses/LICENSE-2.0` for info        //
+//                                                                  //
+//////////////////////////////////////////////////////////////////////
+
+
+#include "./literal_decoding.h"
+
+#include <charconv>
+
+namespace pcit::panther::literal_decoding{
+
+
+	auto splitNumberLiteral(std::string_view literal) noexcept -> NumberLiteral {
+		auto output = NumberLiteral(literal, 10, false, 0);
+
+		if(literal.size() >= 2 && literal[0] == '0'){
+			switch(literal[1]){
+				break; case 'x': output.base = 16;
+				break; case 'b': output.base = 2;
+				break; case 'o': output.base = 8;
+			};
+
+			if(output.base != 10){ output.text = literal.substr(2); }
+		}
+
+		// only base-10 literals can have an exponent ('e' is a digit in base-16)
+		if(output.base != 10){ return output; }
+
+		const size_t exponent_start = output.text.find_first_of("eE");
+		if(exponent_start == std::string_view::npos){ return output; }
+
+		std::string_view exponent_str = output.text.substr(exponent_start + 1);
+		if(exponent_str.empty() == false && (exponent_str[0] == '-' || exponent_str[0] == '+')){
+			output.exponentIsNegative = exponent_str[0] == '-';
+			exponent_str.remove_prefix(1);
+		}
+
+		for(const char exponent_char : exponent_str){
+			output.exponent = std::min(
+				output.exponent * 10 + uint64_t(exponent_char - '0'), uint64_t(std::numeric_limits<uint32_t>::max())
+			);
+		}
+
+		return output;
+	};
+
+
+
+	EVO_NODISCARD static constexpr auto digit_value(char digit) noexcept -> uint64_t {
+		if(evo::isNumber(digit)){ return uint64_t(digit - '0'); }
+		if(digit >= 'a' && digit <= 'f'){ return uint64_t(digit - 'a' + 10); }
+		if(digit >= 'A' && digit <= 'F'){ return uint64_t(digit - 'A' + 10); }
+		evo::debugFatalBreak("Not a valid digit");
+	};
+
+	auto decodeIntDigits(std::string_view digits, int base) noexcept -> std::optional<uint64_t> {
+		uint64_t value = 0;
+
+		for(const char digit_char : digits){
+			if(digit_char == '_'){ continue; }
+
+			const uint64_t digit = digit_value(digit_char);
+
+			if(value > (std::numeric_limits<uint64_t>::max() - digit) / uint64_t(base)){ return std::nullopt; }
+
+			value = value * uint64_t(base) + digit;
+		}
+
+		return value;
+	};
+
+	auto applyIntExponent(uint64_t value, uint64_t exponent) noexcept -> std::optional<uint64_t> {
+		for(uint64_t i = 0; i < exponent && value != 0; i+=1){
+			if(value > std::numeric_limits<uint64_t>::max() / 10){ return std::nullopt; }
+
+			value *= 10;
+		}
+
+		return value;
+	};
+
+
+	auto decodeInt(const NumberLiteral& literal) noexcept -> std::optional<uint64_t> {
+		evo::debugAssert(
+			literal.exponentIsNegative == false || literal.exponent == 0,
+			"Literal integers cannot have a negative exponent"
+		);
+
+		const size_t digits_end = literal.base == 10 ? literal.text.find_first_of("eE") : std::string_view::npos;
+
+		const std::optional<uint64_t> value = decodeIntDigits(literal.text.substr(0, digits_end), literal.base);
+		if(value.has_value() == false){ return std::nullopt; }
+
+		return applyIntExponent(*value, literal.exponent);
+	};
+
+
+
+	// Used to tell if a floating-point literal that std::from_chars said was out of range underflowed (becomes 0)
+	// 		or overflowed (error). Only needs to be approximate as it's only used for values near the limits of F64.
+	EVO_NODISCARD static auto float_literal_is_too_small(
+		std::string_view float_str, bool exponent_is_negative, uint64_t exponent
+	) noexcept -> bool {
+		const size_t mantissa_end = std::min(float_str.find_first_of("eE"), float_str.size());
+		const std::string_view mantissa = float_str.substr(0, mantissa_end);
+		const size_t decimal_point_index = std::min(mantissa.find('.'), mantissa.size());
+		const size_t first_non_zero_index = std::min(mantissa.find_first_not_of("0."), mantissa.size());
+
+		// roughly the number of digits before (or after if negative) the decimal point of the first non-zero digit
+		int64_t magnitude = int64_t(decimal_point_index) - int64_t(first_non_zero_index);
+		magnitude += exponent_is_negative ? -int64_t(exponent) : int64_t(exponent);
+
+		return magnitude <= 0;
+	};
+
+	auto decodeFloat(const NumberLiteral& literal) noexcept -> DecodedFloat {
+		// std::from_chars is correctly rounded and handles the exponent itself,
+		// 		but doesn't accept digit separators (those are removed into a buffer first)
+		auto no_separators_buffer = std::array<char, 64>();
+		auto no_separators_fallback = std::string();
+		std::string_view float_str = literal.text;
+
+		if(literal.text.find('_') != std::string_view::npos){
+			if(literal.text.size() <= no_separators_buffer.size()){
+				const auto copy_result = std::ranges::remove_copy(literal.text, no_separators_buffer.begin(), '_');
+				float_str = std::string_view(no_separators_buffer.begin(), copy_result.out);
+
+			}else{
+				std::ranges::remove_copy(literal.text, std::back_inserter(no_separators_fallback), '_');
+				float_str = no_separators_fallback;
+			}
+		}
+
+		auto output = DecodedFloat(0.0, std::errc());
+
+		const std::from_chars_result parse_result = std::from_chars(
+			float_str.data(),
+			float_str.data() + float_str.size(),
+			output.value,
+			literal.base == 16 ? std::chars_format::hex : std::chars_format::general
+		);
+
+		if(parse_result.ec == std::errc::result_out_of_range){
+			if(float_literal_is_too_small(float_str, literal.exponentIsNegative, literal.exponent)){
+				output.value = 0.0;
+			}else{
+				output.ec = std::errc::result_out_of_range;
+			}
+
+		}else if(parse_result.ec != std::errc() || parse_result.ptr != float_str.data() + float_str.size()){
+			output.ec = std::errc::invalid_argument;
+		}
+
+		return output;
+	};
+
+
+
+	auto decodeEscapeSequence(char escape_char) noexcept -> std::optional<char> {
+		switch(escape_char){
+			case '0': return '\0';
+			case 'a': return '\a';
+			case 'b': return '\b';
+			case 't': return '\t';
+			case 'n': return '\n';
+			case 'v': return '\v';
+			case 'f': return '\f';
+			case 'r': return '\r';
+
+			case '\'': return '\'';
+			case '"':  return '"';
+			case '\\': return '\\';
+		};
+
+		return std::nullopt;
+	};
+
+
+	auto decodeText(std::string_view literal) noexcept -> std::string {
+		auto output = std::string();
+		output.reserve(literal.size());
+
+		size_t cursor = 0;
+		while(cursor < literal.size()){
+			const size_t escape_index = std::min(literal.find('\\', cursor), literal.size());
+			output.append(literal.substr(cursor, escape_index - cursor));
+
+			if(escape_index == literal.size()){ break; }
+
+			evo::debugAssert(escape_index + 1 < literal.size(), "Unterminated escape sequence");
+			const std::optional<char> escaped_char = decodeEscapeSequence(literal[escape_index + 1]);
+			evo::debugAssert(escaped_char.has_value(), "Unknown escape sequence");
+
+			output += *escaped_char;
+			cursor = escape_index + 2;
+		};
+
+		return output;
+	};
+
+
+};
@@ -0,0 +1,61 @@
+//////////////////////////////////////////////////////////////////////
+//                                                                  //
+// Part of the PCIT-CPP, under the Apache License v2.0              //
+// You may not use this file except in compliance with the License. //
+// See `http://www.apache.org/licenses/LICENSE-2.0` for info        //
+//                                                                  //
+//////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+
+#include <system_error>
+
+#include <Evo.h>
+#include <PCIT_core.h>
+
+
+// Decoding of the values of literals, used by the Tokenizer and by `TokenBuffer` (to decode the values of literals
+// 		that were tokenized with `Context::Config::lazyLiteralValues`).
+// Literals passed to these have already been validated by the Tokenizer (except for being too large).
+
+namespace pcit::panther::literal_decoding{
+
+
+	struct NumberLiteral{
+		std::string_view text; // without the base prefix (digits, separators, decimal point, and then the exponent)
+		int base;
+		bool exponentIsNegative;
+		uint64_t exponent; // saturated to the max of uint32_t (still large enough to always be too large)
+	};
+
+	// `literal` is all of the text of the token
+	EVO_NODISCARD auto splitNumberLiteral(std::string_view literal) noexcept -> NumberLiteral;
+
+
+	// nullopt if too large to fit into a UI64 (`digits` may include digit separators)
+	EVO_NODISCARD auto decodeIntDigits(std::string_view digits, int base) noexcept -> std::optional<uint64_t>;
+	EVO_NODISCARD auto applyIntExponent(uint64_t value, uint64_t exponent) noexcept -> std::optional<uint64_t>;
+
+	// the exponent cannot be negative
+	EVO_NODISCARD auto decodeInt(const NumberLiteral& literal) noexcept -> std::optional<uint64_t>;
+
+
+	struct DecodedFloat{
+		float64_t value;
+		std::errc ec; // `result_out_of_range` if too large to fit into an F64, `invalid_argument` if not valid
+	};
+
+	// values too small to fit into an F64 become 0
+	EVO_NODISCARD auto decodeFloat(const NumberLiteral& literal) noexcept -> DecodedFloat;
+
+
+	// the character an escape sequence (the character after the '\') is for, or nullopt if it's unknown
+	EVO_NODISCARD auto decodeEscapeSequence(char escape_char) noexcept -> std::optional<char>;
+
+	// `literal` is the text between the delimiters
+	EVO_NODISCARD auto decodeText(std::string_view literal) noexcept -> std::string;
+
+
+};
@@ -225,6 +225,7 @@ project("PCIT_core").group = "Libs"
 project("Panther").group = "Libs"
 
 project("pthr").group = "Executables"
+project("pthr_bench").group = "Executables"
 
 
 